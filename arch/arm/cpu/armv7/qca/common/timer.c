@@ -34,6 +34,7 @@
 
 #include <watchdog.h>
 #include <fdtdec.h>
+#include <div64.h>
 
 static unsigned long long timestamp __attribute__((section(".data")));
 static unsigned long long lastinc __attribute__((section(".data")));
@@ -102,7 +103,7 @@ ulong get_timer(ulong base)
  * read_counter - returns 64-bit counter value
  * Reads Timer HI and Timer LO value register
  */
-static unsigned long long read_counter(void)
+static unsigned long long notrace read_counter(void)
 {
 	unsigned long vect_hi1, vect_hi2;
 	unsigned long vect_low;
@@ -131,7 +132,7 @@ uint64_t notrace get_ticks(void)
 }
 
 /* get_ticks - returns the timer frequency */
-unsigned long get_tbclk(void)
+unsigned long notrace get_tbclk(void)
 {
         return GPT_FREQ_HZ;
 }
@@ -202,3 +203,23 @@ ulong get_timer_masked(void)
 
 	return (ulong)timestamp;
 }
+
+#ifdef CONFIG_BOOTSTAGE
+/**
+ * timer_get_boot_us - microseconds since the global counter started
+ *
+ * The counter runs from power on, so bootstage marks also account for
+ * the time spent in the earlier boot stages.
+ */
+ulong notrace timer_get_boot_us(void)
+{
+	/* The first mark is taken before timer_init() in board_init_f() */
+	if (!ipq_timer.gpt_freq_hz)
+		timer_init();
+
+	if (ipq_timer.gpt_freq_hz == -1 || GPT_FREQ_KHZ == 0)
+		return 0;
+
+	return (ulong)lldiv(read_counter() * 1000, GPT_FREQ_KHZ);
+}
+#endif
@@ -120,8 +120,49 @@ void set_ethmac_addr(void);
 void aquantia_phy_reset_init_done(void);
 void aquantia_phy_reset_init(void);
 
+/* Flash partition the HLOS image is read from, see hlos_load.c */
+struct hlos_src {
+	/* Read len bytes at partition offset off, both multiples of align */
+	int (*read_start)(struct hlos_src *src, ulong off, ulong len,
+			  void *dst);
+	int (*read_finish)(struct hlos_src *src);
+	ulong size;		/* partition size */
+	ulong align;
+	ulong max_read;		/* longest single read */
+	int dev;
+	ulong start;
+	void *flash;
+	char *volume;
+	int err;
+};
+
+int hlos_load(struct hlos_src *src, void *dst);
+int hlos_src_mmc(struct hlos_src *src, int dev_num, ulong start,
+		 ulong blkcnt, ulong blksz);
+int hlos_src_nor(struct hlos_src *src, ulong offset, ulong size);
+int hlos_src_ubi(struct hlos_src *src, char *volume);
+
+#ifdef CONFIG_IPQ_LAZY_INIT
+/* Subsystems brought up on first use, see lazy_init.c */
+enum ipq_lazy_dev {
+	IPQ_LAZY_USB,
+	IPQ_LAZY_PCI,
+	IPQ_LAZY_NET,
+	IPQ_LAZY_MAX
+};
+
+int ipq_lazy_init(enum ipq_lazy_dev dev);
+int ipq_lazy_is_up(enum ipq_lazy_dev dev);
+void ipq_lazy_mark_down(enum ipq_lazy_dev dev);
+void ipq_lazy_init_all(void);
+void ipq_lazy_init_eager(void);
+#endif
+
 int bring_sec_core_up(unsigned int cpuid, unsigned int entry, unsigned int arg);
 int is_secondary_core_off(unsigned int cpuid);
+int multicore_start(int nr, char * const cmds[]);
+int multicore_done(int cpu);
+int multicore_finish(void);
 int smem_read_cpu_count(void);
 int get_soc_hw_version(void);
 int is_atf_enabled(void);
@@ -263,7 +263,19 @@ enum {
 	MMU_SECTION_SIZE	= 1 << MMU_SECTION_SHIFT,
 };
 
-#ifdef CONFIG_ARMV7
+/*
+ * A supersection maps 16MB; its descriptor has bit 18 set and is
+ * repeated in the 16 consecutive level 1 entries it covers.
+ */
+#define TTB_SECT_SUPER_MASK	(1 << 18)
+enum {
+	MMU_SUPERSECTION_SHIFT	= 24,
+	MMU_SUPERSECTION_SIZE	= 1 << MMU_SUPERSECTION_SHIFT,
+	MMU_SUPERSECTION_ENTRIES = 1 << (MMU_SUPERSECTION_SHIFT -
+					 MMU_SECTION_SHIFT),
+};
+
+#if defined(CONFIG_ARMV7) || defined(CONFIG_IPQ_NO_RELOC)
 /* TTBR0 bits */
 #define TTBR0_BASE_ADDR_MASK	0xFFFFC000
 #define TTBR0_RGN_NC			(0 << 3)
@@ -305,8 +317,32 @@ void mmu_set_region_dcache_behaviour(phys_addr_t start, size_t size,
 				     enum dcache_option option);
 
 #ifdef CONFIG_SYS_NONCACHED_MEMORY
+/*
+ * A driver's private slice of the uncached region. Allocations from it
+ * are ARCH_DMA_MINALIGN aligned, zeroed and need no cache maintenance;
+ * they can only be given back all at once with noncached_pool_reset().
+ */
+struct noncached_pool {
+	const char *name;
+	phys_addr_t start;
+	phys_addr_t end;
+	phys_addr_t next;
+};
+
 void noncached_init(void);
+void noncached_mmu_setup(void);
 phys_addr_t noncached_alloc(size_t size, size_t align);
+int noncached_range(unsigned long start, size_t size);
+int noncached_pool_init(struct noncached_pool *pool, const char *name,
+			size_t size);
+void *noncached_pool_alloc(struct noncached_pool *pool, size_t size,
+			   size_t align);
+void noncached_pool_reset(struct noncached_pool *pool);
+#else
+static inline int noncached_range(unsigned long start, size_t size)
+{
+	return 0;
+}
 #endif /* CONFIG_SYS_NONCACHED_MEMORY */
 
 #endif /* __ASSEMBLY__ */
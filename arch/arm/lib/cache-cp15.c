@@ -14,6 +14,9 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+#define TTB_SECT_TYPE		2
+#define MMU_SECTION_ADDR_MASK	(~(MMU_SECTION_SIZE - 1))
+
 __weak void arm_init_before_mmu(void)
 {
 }
@@ -36,6 +39,21 @@ void set_section_dcache(int section, enum dcache_option option)
 {
 	u32 *page_table = (u32 *)gd->arch.tlb_addr;
 	u32 value;
+	int i, first;
+
+	/*
+	 * A supersection covers this entry: split the whole group back
+	 * into plain sections with the same attributes before changing
+	 * just one of them.
+	 */
+	value = page_table[section];
+	if ((value & 3) == TTB_SECT_TYPE && (value & TTB_SECT_SUPER_MASK)) {
+		first = section & ~(MMU_SUPERSECTION_ENTRIES - 1);
+		value &= ~(MMU_SECTION_ADDR_MASK | TTB_SECT_SUPER_MASK);
+		for (i = 0; i < MMU_SUPERSECTION_ENTRIES; i++)
+			page_table[first + i] = value |
+				((first + i) << MMU_SECTION_SHIFT);
+	}
 
 	value = (section << MMU_SECTION_SHIFT) | (3 << 10);
 	value |= option;
@@ -59,6 +77,9 @@ void mmu_set_region_dcache_behaviour(phys_addr_t start, size_t size,
 	      option);
 	for (upto = start; upto < end; upto++)
 		set_section_dcache(upto, option);
+	/* Splitting a supersection may have touched its whole group */
+	start &= ~(MMU_SUPERSECTION_ENTRIES - 1);
+	end = ALIGN(end, MMU_SUPERSECTION_ENTRIES);
 	mmu_page_table_flush((u32)&page_table[start], (u32)&page_table[end]);
 }
 
@@ -66,20 +87,52 @@ void mmu_set_region_dcache_behaviour(phys_addr_t start, size_t size,
 #define UBOOT_CACHE_SETUP	0x100e
 #define GEN_CACHE_SETUP		0x101e
 
+#define UBOOT_SECTION_START	(CONFIG_SYS_TEXT_BASE >> 20)
+#define UBOOT_SECTION_END	((CONFIG_SYS_TEXT_BASE + 0x100000) >> 20)
+
+/* Map 16MB with a single (replicated) supersection descriptor */
+static void set_supersection_dcache(int section, u32 option)
+{
+	u32 *page_table = (u32 *)gd->arch.tlb_addr;
+	u32 value;
+	int i;
+
+	value = (section << MMU_SECTION_SHIFT) | TTB_SECT_SUPER_MASK |
+		(3 << 10) | option;
+	for (i = 0; i < MMU_SUPERSECTION_ENTRIES; i++)
+		page_table[section + i] = value;
+}
+
 __weak void dram_bank_mmu_setup(int bank)
 {
 	bd_t *bd = gd->bd;
-	unsigned long long	i;
+	unsigned long long	i, end;
 
 	debug("%s: bank: %d\n", __func__, bank);
-	for (i = bd->bi_dram[bank].start >> 20;
-	     i < ((unsigned long long)bd->bi_dram[bank].start + (unsigned long long)bd->bi_dram[bank].size) >> 20;
-	     i++) {
+	end = ((unsigned long long)bd->bi_dram[bank].start +
+	       (unsigned long long)bd->bi_dram[bank].size) >> 20;
+	for (i = bd->bi_dram[bank].start >> 20; i < end; i++) {
 		/* Set XN bit for all dram regions except uboot code region */
-		if (i >= (CONFIG_SYS_TEXT_BASE >> 20) && i < ((CONFIG_SYS_TEXT_BASE + 0x100000) >> 20))
+		if (i >= UBOOT_SECTION_START && i < UBOOT_SECTION_END) {
 			set_section_dcache(i, UBOOT_CACHE_SETUP);
-		else
-			set_section_dcache(i, GEN_CACHE_SETUP);
+			continue;
+		}
+
+		/*
+		 * Use a supersection for every fully populated 16MB group
+		 * that does not hold the U-Boot code, so DRAM costs a
+		 * sixteenth of the TLB entries it used to.
+		 */
+		if (!(i & (MMU_SUPERSECTION_ENTRIES - 1)) &&
+		    i + MMU_SUPERSECTION_ENTRIES <= end &&
+		    (UBOOT_SECTION_END <= i ||
+		     UBOOT_SECTION_START >= i + MMU_SUPERSECTION_ENTRIES)) {
+			set_supersection_dcache(i, GEN_CACHE_SETUP);
+			i += MMU_SUPERSECTION_ENTRIES - 1;
+			continue;
+		}
+
+		set_section_dcache(i, GEN_CACHE_SETUP);
 	}
 }
 
@@ -98,10 +151,18 @@ void mmu_setup(void)
 	for (i = 0; i < CONFIG_NR_DRAM_BANKS; i++) {
 		dram_bank_mmu_setup(i);
 	}
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	noncached_mmu_setup();
+#endif
 
-	/* Copy the page table address to cp15 */
+	/*
+	 * Set TTBR0, letting table walks hit in the (write-back,
+	 * write-allocate) caches like the rest of DRAM does.
+	 */
+	reg = gd->arch.tlb_addr & TTBR0_BASE_ADDR_MASK;
+	reg |= TTBR0_RGN_WBWA | TTBR0_IRGN_WBWA;
 	asm volatile("mcr p15, 0, %0, c2, c0, 0"
-		     : : "r" (gd->arch.tlb_addr) : "memory");
+		     : : "r" (reg) : "memory");
 
 	/* Set the access control to all clients */
 	set_dacr(0x55555555);
@@ -146,6 +207,9 @@ void mmu_setup(void)
 	for (i = 0; i < CONFIG_NR_DRAM_BANKS; i++) {
 		dram_bank_mmu_setup(i);
 	}
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	noncached_mmu_setup();
+#endif
 
 #ifdef CONFIG_ARMV7
 	/* Set TTBR0 */
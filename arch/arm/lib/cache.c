@@ -9,6 +9,7 @@
 
 #include <common.h>
 #include <malloc.h>
+#include <asm/errno.h>
 
 /*
  * Flush range from all levels of d-cache/unified-cache.
@@ -63,6 +64,10 @@ void noncached_init(void)
 	phys_addr_t start, end;
 	size_t size;
 
+	/* Already set up: keep what has been handed out so far */
+	if (noncached_end)
+		return;
+
 	end = ALIGN(mem_malloc_start, MMU_SECTION_SIZE) - MMU_SECTION_SIZE;
 	size = ALIGN(CONFIG_SYS_NONCACHED_MEMORY, MMU_SECTION_SIZE);
 	start = end - size;
@@ -78,9 +83,29 @@ void noncached_init(void)
 #endif
 }
 
+/*
+ * mmu_setup() rebuilds the page table with all of DRAM cached each time
+ * the dcache is switched back on, so the window has to be mapped
+ * uncached again before the MMU is enabled.
+ */
+void noncached_mmu_setup(void)
+{
+#ifndef CONFIG_SYS_DCACHE_OFF
+	if (noncached_end)
+		mmu_set_region_dcache_behaviour(noncached_start,
+						noncached_end - noncached_start,
+						DCACHE_OFF);
+#endif
+}
+
 phys_addr_t noncached_alloc(size_t size, size_t align)
 {
-	phys_addr_t next = ALIGN(noncached_next, align);
+	phys_addr_t next;
+
+	/* Never share a cache line with a neighbouring cached user */
+	if (align < ARCH_DMA_MINALIGN)
+		align = ARCH_DMA_MINALIGN;
+	next = ALIGN(noncached_next, align);
 
 	if (next >= noncached_end || (noncached_end - next) < size)
 		return 0;
@@ -90,6 +115,68 @@ phys_addr_t noncached_alloc(size_t size, size_t align)
 
 	return next;
 }
+
+/*
+ * Returns non-zero if [start, start + size) lies in the uncached region,
+ * i.e. the device sees CPU accesses to it without any cache maintenance.
+ */
+int noncached_range(unsigned long start, size_t size)
+{
+	return start >= noncached_start && start < noncached_end &&
+	       (noncached_end - start) >= size;
+}
+
+/*
+ * Give a driver its own slice of the uncached region, so all of its
+ * descriptor memory sits together. Calling it again on a set up pool
+ * is a no-op.
+ */
+int noncached_pool_init(struct noncached_pool *pool, const char *name,
+			size_t size)
+{
+	phys_addr_t start;
+
+	if (pool->start)
+		return 0;
+
+	start = noncached_alloc(size, ARCH_DMA_MINALIGN);
+	if (!start) {
+		printf("%s: no uncached memory left for %zu bytes\n",
+		       name, size);
+		return -ENOMEM;
+	}
+
+	pool->name = name;
+	pool->start = start;
+	pool->end = start + size;
+	pool->next = start;
+
+	return 0;
+}
+
+void *noncached_pool_alloc(struct noncached_pool *pool, size_t size,
+			   size_t align)
+{
+	phys_addr_t next;
+
+	if (align < ARCH_DMA_MINALIGN)
+		align = ARCH_DMA_MINALIGN;
+	next = ALIGN(pool->next, align);
+
+	if (!pool->start || next >= pool->end || (pool->end - next) < size)
+		return NULL;
+
+	debug("%s: allocated %zu bytes @%pa\n", pool->name, size, &next);
+	pool->next = next + size;
+	memset((void *)next, 0, size);
+
+	return (void *)next;
+}
+
+void noncached_pool_reset(struct noncached_pool *pool)
+{
+	pool->next = pool->start;
+}
 #endif /* CONFIG_SYS_NONCACHED_MEMORY */
 
 #if defined(CONFIG_SYS_THUMB_BUILD)
@@ -201,6 +201,12 @@ int board_init(void)
 	qca_smem_flash_info_t *sfi = &qca_smem_flash_info;
 
 	gd->bd->bi_boot_params = QCA_BOOT_PARAMS_ADDR;
+#ifdef CONFIG_TRACE
+	/* The hidden trace window is outside the DRAM bank mapped cached */
+	mmu_set_region_dcache_behaviour((ulong)gd->trace_buff,
+					CONFIG_TRACE_BUFFER_SIZE,
+					DCACHE_WRITEALLOC);
+#endif
 #ifndef CONFIG_OF_BOARD_FIXUP
 	gd->bd->bi_arch_number = smem_get_board_platform_type();
 #endif
@@ -219,7 +225,10 @@ int board_init(void)
 	case SMEM_BOOT_MMC_FLASH:
 		break;
 	default:
+		bootstage_mark_name(BOOTSTAGE_ID_SMEM_PTABLE, "smem_ptable");
 		ret = smem_ptable_init();
+		bootstage_mark_name(BOOTSTAGE_ID_SMEM_PTABLE_DONE,
+				    "smem_ptable_done");
 		if (ret < 0) {
 			if (sfi->flash_type == SMEM_BOOT_NO_FLASH) {
 				printf("cdp: SMEM init skipped, flash type unknown\n");
@@ -313,10 +322,12 @@ int board_init(void)
 #endif
 	}
 #endif
+#ifndef CONFIG_IPQ_LAZY_INIT
 	ret = ipq_board_usb_init();
 	if (ret < 0) {
 		printf("WARN: ipq_board_usb_init failed\n");
 	}
+#endif
 
 #if defined(CONFIG_IPQ9574_EDMA)
 	aquantia_phy_reset_init();
@@ -514,7 +525,10 @@ int board_late_init(void)
 
 	if (sfi->flash_type != SMEM_BOOT_MMC_FLASH &&
 	    sfi->flash_type != SMEM_BOOT_NO_FLASH) {
+		bootstage_mark_name(BOOTSTAGE_ID_PART_DETAILS, "part_details");
 		get_kernel_fs_part_details();
+		bootstage_mark_name(BOOTSTAGE_ID_PART_DETAILS_DONE,
+				    "part_details_done");
 	}
 
 	/* get machine type from SMEM and set in env */
@@ -610,6 +624,9 @@ int board_late_init(void)
 		sdi_disable();
 	}
 
+#ifdef CONFIG_IPQ_LAZY_INIT
+	ipq_lazy_init_eager();
+#endif
 	return 0;
 }
 
@@ -29,6 +29,9 @@
 #include <asm/arch-qca-common/qca_common.h>
 #include <usb.h>
 #include <elf.h>
+#ifdef CONFIG_SPI_FLASH
+#include <spi_flash.h>
+#endif
 
 #define SEC_AUTH_SW_ID 		0x17
 #define ROOTFS_IMAGE_TYPE       0x13
@@ -594,6 +597,7 @@ static int do_boot_signedimg(cmd_tbl_t *cmdtp, int flag, int argc, char *const a
 		BUG();
 	}
 #endif
+	bootstage_mark_name(BOOTSTAGE_KERNELREAD_START, "kernel_read");
 	if (ipq_fs_on_nand) {
 #ifdef CONFIG_CMD_UBI
 		/*
@@ -719,6 +723,7 @@ static int do_boot_signedimg(cmd_tbl_t *cmdtp, int flag, int argc, char *const a
 
 		kernel_img_info.kernel_load_size =  sfi->hlos.size;
 	}
+	bootstage_mark_name(BOOTSTAGE_KERNELREAD_STOP, "kernel_read_done");
 
 	setenv("mtdids", mtdids);
 
@@ -789,10 +794,9 @@ static int do_boot_signedimg(cmd_tbl_t *cmdtp, int flag, int argc, char *const a
 #ifdef CONFIG_QCA_MMC
 		mmc_initialize(gd->bd);
 #endif
-#ifdef CONFIG_USB_XHCI_IPQ
+#if defined(CONFIG_USB_XHCI_IPQ) && !defined(CONFIG_IPQ_LAZY_INIT)
 		ipq_board_usb_init();
 #endif
-		dcache_disable();
 		return CMD_RET_FAILURE;
 	}
 
@@ -808,6 +812,8 @@ static int do_boot_unsignedimg(cmd_tbl_t *cmdtp, int flag, int argc, char *const
 	int ret;
 	char runcmd[256];
 	char * const arg[1] = {runcmd};
+	struct hlos_src src = { 0 };
+	int use_ubi = 0;
 #ifdef CONFIG_QCA_MMC
 	block_dev_desc_t *blk_dev;
 	disk_partition_t disk_info;
@@ -845,10 +851,9 @@ static int do_boot_unsignedimg(cmd_tbl_t *cmdtp, int flag, int argc, char *const
 		snprintf(runcmd, sizeof(runcmd),
 			 "setenv mtdids nand0=nand0 && "
 			 "setenv mtdparts mtdparts=nand0:0x%llx@0x%llx(fs),${msmparts} && "
-			 "ubi part fs && "
-			 "ubi read 0x%x kernel && ",
-			 sfi->rootfs.size, sfi->rootfs.offset,
-			 CONFIG_SYS_LOAD_ADDR);
+			 "ubi part fs",
+			 sfi->rootfs.size, sfi->rootfs.offset);
+		use_ubi = 1;
 
 	} else if (((sfi->flash_type == SMEM_BOOT_SPI_FLASH) &&
 		    (sfi->rootfs.offset != 0xBAD0FF5E)) ||
@@ -858,22 +863,22 @@ static int do_boot_unsignedimg(cmd_tbl_t *cmdtp, int flag, int argc, char *const
 				 "nand device %d && "
 				 "setenv mtdids nand%d=nand%d && "
 				 "setenv mtdparts mtdparts=nand%d:0x%llx@0x%llx(fs),${msmparts} && "
-				 "ubi part fs && "
-				 "ubi read 0x%x kernel && ",
+				 "ubi part fs",
 				 is_spi_nand_available(),
 				 is_spi_nand_available(),
 				 is_spi_nand_available(),
 				 is_spi_nand_available(),
-				 sfi->rootfs.size, sfi->rootfs.offset,
-				 CONFIG_SYS_LOAD_ADDR);
+				 sfi->rootfs.size, sfi->rootfs.offset);
+			use_ubi = 1;
 		} else {
 			/*
 			 * Kernel is in a separate partition
 			 */
-			snprintf(runcmd, sizeof(runcmd),
-				 "sf probe &&"
-				 "sf read 0x%x 0x%x 0x%x && ",
-				 CONFIG_SYS_LOAD_ADDR, (uint)sfi->hlos.offset, (uint)sfi->hlos.size);
+			if (hlos_src_nor(&src, sfi->hlos.offset,
+					 sfi->hlos.size)) {
+				printf("SPI probe failed.\n");
+				return CMD_RET_FAILURE;
+			}
 		}
 #ifdef CONFIG_QCA_MMC
 	} else if ((sfi->flash_type == SMEM_BOOT_MMC_FLASH) ||
@@ -897,10 +902,10 @@ static int do_boot_unsignedimg(cmd_tbl_t *cmdtp, int flag, int argc, char *const
 						"0:HLOS", &disk_info);
 		}
 
-		if (ret == 0) {
-			snprintf(runcmd, sizeof(runcmd), "mmc read 0x%x 0x%x 0x%x",
-				 CONFIG_SYS_LOAD_ADDR,
-				 (uint)disk_info.start, (uint)disk_info.size);
+		if (ret || hlos_src_mmc(&src, host->dev_num, disk_info.start,
+					disk_info.size, disk_info.blksz)) {
+			printf("HLOS partition not found\n");
+			return CMD_RET_FAILURE;
 		}
 
 #endif   /* CONFIG_QCA_MMC   */
@@ -909,12 +914,28 @@ static int do_boot_unsignedimg(cmd_tbl_t *cmdtp, int flag, int argc, char *const
 		return -1;
 	}
 
-	if (run_command(runcmd, 0) != CMD_RET_SUCCESS) {
+	bootstage_mark_name(BOOTSTAGE_KERNELREAD_START, "kernel_read");
+	ret = CMD_RET_SUCCESS;
+	if (use_ubi) {
+		ret = run_command(runcmd, 0);
+		if (ret == CMD_RET_SUCCESS)
+			ret = hlos_src_ubi(&src, "kernel");
+	}
+	if (ret == CMD_RET_SUCCESS)
+		ret = hlos_load(&src, (void *)CONFIG_SYS_LOAD_ADDR);
+#ifdef CONFIG_SPI_FLASH
+	/* Probed again on the next attempt */
+	if (src.flash)
+		spi_flash_free(src.flash);
+#endif
+	if (ret != CMD_RET_SUCCESS) {
+		fit_image_hash_clear_verified();
 #ifdef CONFIG_QCA_MMC
 		mmc_initialize(gd->bd);
 #endif
 		return CMD_RET_FAILURE;
 	}
+	bootstage_mark_name(BOOTSTAGE_KERNELREAD_STOP, "kernel_read_done");
 
 	dcache_enable();
 
@@ -947,21 +968,24 @@ static int do_boot_unsignedimg(cmd_tbl_t *cmdtp, int flag, int argc, char *const
 						  sizeof(mbn_header_t)));
 
 		} else {
-			dcache_disable();
+			fit_image_hash_clear_verified();
 			return CMD_RET_FAILURE;
 		}
 	}
 
 #ifdef CONFIG_SKIP_RESET
-	if (apps_iscrashed())
+	if (apps_iscrashed()) {
+		fit_image_hash_clear_verified();
 		return 1;
+	}
 #endif
 
 	if (ret < 0 || boot_os(1, arg) != CMD_RET_SUCCESS) {
-#ifdef CONFIG_USB_XHCI_IPQ
+		/* Nothing loaded here may skip its hash check later */
+		fit_image_hash_clear_verified();
+#if defined(CONFIG_USB_XHCI_IPQ) && !defined(CONFIG_IPQ_LAZY_INIT)
 		ipq_board_usb_init();
 #endif
-		dcache_disable();
 		return CMD_RET_FAILURE;
 	}
 #ifndef CONFIG_QCA_APPSBL_DLOAD
@@ -1006,7 +1030,9 @@ static int do_bootipq(cmd_tbl_t *cmdtp, int flag, int argc, char *const argv[])
 
 	if (ret == CMD_RET_FAILURE) {
 #if !defined(CONFIG_IPQ5332) && !defined(CONFIG_IPQ9574)
-#ifdef CONFIG_IPQ_ETH_INIT_DEFER
+#if defined(CONFIG_IPQ_LAZY_INIT)
+		ipq_lazy_init(IPQ_LAZY_NET);
+#elif defined(CONFIG_IPQ_ETH_INIT_DEFER)
 		puts("\nNet:   ");
 		eth_initialize();
 #endif
@@ -17,11 +17,19 @@
 #include <cli.h>
 #include <console.h>
 #include <linux/linkage.h>
+#include <asm/errno.h>
+#include <asm/arch-qca-common/qca_common.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
-#define SECONDARY_CORE_STACKSZ (8 * 1024)
+/*
+ * cli_simple_run_command() alone keeps two CONFIG_SYS_CBSIZE buffers on
+ * the stack, the command and printf() come on top of that.
+ */
+#define SECONDARY_CORE_STACKSZ (32 * 1024)
 #define CPU_POWER_DOWN (1 << 16)
+#define CPU_UP_TIMEOUT_MS	5000
+#define CPU_DOWN_TIMEOUT_MS	5000
 
 extern void *globl_core_array;
 
@@ -40,6 +48,9 @@ extern void bring_secondary_core_down(int);
 
 struct cpu_entry_arg core[NR_CPUS - 1];
 
+/* Cores brought up by the last multicore_start() */
+static int nr_cores_up;
+
 asmlinkage void secondary_core_entry(char *argv, int *cmd_complete,
 					int *cmd_result)
 {
@@ -63,36 +74,39 @@ static void enable_console(void)
 	gd->flags &= ~(GD_FLG_SILENT | GD_FLG_DISABLE_CONSOLE);
 }
 
-int do_runmulticore(cmd_tbl_t *cmdtp,
-			   int flag, int argc, char *const argv[])
+/*
+ * Run cmds[0] .. cmds[nr - 1] on cores 1 .. nr without waiting for them.
+ * The secondary cores run with caches off, so the data cache stays
+ * disabled until multicore_finish(), which must be called even if this
+ * fails: the cores that did come up are running their commands.
+ */
+int multicore_start(int nr, char * const cmds[])
 {
 	int j;
 	int i;
 	int ret;
 	int delay = 0;
-	int core_status = 0;
-	int core_on_status = 0;
 	char *ptr = NULL;
 
-	if ((argc <= 1) || (argc > 4))
-		return CMD_RET_USAGE;
+	if ((nr < 1) || (nr > NR_CPUS - 1))
+		return -EINVAL;
 
+	nr_cores_up = 0;
 	dcache_disable();
 
 	/* Setting up stack for secondary cores */
 	memset(core, 0, sizeof(core));
 
 	globl_core_array = core;
-	for (i = 1; i < argc; i++) {
+	for (i = 1; i <= nr; i++) {
 		ptr = malloc(SECONDARY_CORE_STACKSZ);
 		if (NULL == ptr) {
-			j = i - 1;
-			while (j >= 0) {
-				free(core[i - 1].stack_ptr);
-				j--;
-			}
+			for (j = 1; j < i; j++)
+				free(core[j - 1].stack_top_ptr);
 			printf("Memory allocation failure\n");
-			return CMD_RET_FAILURE;
+			invalidate_dcache_all();
+			dcache_enable();
+			return -ENOMEM;
 		}
 		/* 0xf0 is the padding length */
 		core[i - 1].stack_top_ptr = ptr;
@@ -102,63 +116,67 @@ int do_runmulticore(cmd_tbl_t *cmdtp,
 		core[i - 1].cmd_complete = 0;
 		core[i - 1].cmd_result = -1;
 		core[i - 1].gd_ptr = gd;
-		core[i - 1].arg_ptr = argv[i];
+		core[i - 1].arg_ptr = cmds[i - 1];
 	}
 
 	/* Bringing up the secondary cores */
-	for (i = 1; i < argc; i++) {
+	for (i = 1; i <= nr; i++) {
 		printf("Scheduling Core %d\n", i);
 		delay = 0;
 		disable_console();
 		ret = bring_sec_core_up(i, (unsigned int)secondary_cpu_init,
 				(unsigned int)&(core[i - 1]));
-		if (ret) {
-			panic("Some problem to getting core %d up\n", i);
-		}
-		while ((delay < 5) && (!(core[i - 1].cpu_up))) {
-			mdelay(1000);
+		while (!ret && (delay < CPU_UP_TIMEOUT_MS) &&
+		       (!(core[i - 1].cpu_up))) {
+			mdelay(1);
 			delay++;
 		}
-		if (!(core[i - 1].cpu_up)) {
-			panic("Can't bringup core %d\n",i);
-		}
 		enable_console();
-
-		core_status |= (BIT(i - 1));
-		core_on_status |= (BIT(i - 1));
-	}
-
-	/* Waiting for secondary cores to complete the task */
-	while (core_status) {
-		for (i = 1; i < argc; i++) {
-			if ((core_status & (BIT(i - 1))) &&
-					(core[i - 1].cmd_complete)) {
-				printf("Command on core %d is %s\n", i,
-					core[i - 1].cmd_complete ?
-					((core[i - 1].cmd_result == -1) ?
-					"FAIL" : "PASS"):
-					"INCOMPLETE");
-				core_status &= (~BIT((i - 1)));
-			}
-		}
-		if (ctrlc()) {
-			run_command("reset", 0);
+		if (ret || !(core[i - 1].cpu_up)) {
+			printf("Can't bringup core %d\n", i);
+			/*
+			 * The core may still come up late, so its stack is
+			 * left allocated; the ones never used are freed.
+			 */
+			for (j = i + 1; j <= nr; j++)
+				free(core[j - 1].stack_top_ptr);
+			return -EIO;
 		}
+		nr_cores_up = i;
 	}
 
-	for (i = 1; (core_status && (i < argc)); i++) {
-		if (core_status & (BIT(i - 1))) {
-			printf("Command on core %d is %s\n", i,
-				core[i - 1].cmd_complete ?
-				((core[i - 1].cmd_result == -1) ?
-				 "FAIL" : "PASS"): "INCOMPLETE");
-		}
+	return 0;
+}
+
+/* Non-zero once the command started on core cpu has returned */
+int multicore_done(int cpu)
+{
+	return core[cpu - 1].cmd_complete;
+}
+
+/*
+ * Wait for the cores started by multicore_start() to finish and power
+ * down, then release their stacks. Returns 0 if every command passed.
+ */
+int multicore_finish(void)
+{
+	int i;
+	int nr = nr_cores_up;
+	int delay = 0;
+	int failed = 0;
+	int core_on_status = 0;
+
+	for (i = 1; i <= nr; i++) {
+		while (!multicore_done(i))
+			;
+		if (core[i - 1].cmd_result == -1)
+			failed = 1;
+		core_on_status |= (BIT(i - 1));
 	}
 
 	/* Waiting for cores to powerdown */
-	delay = 0;
 	while (core_on_status) {
-		for (i = 1; i < argc; i++) {
+		for (i = 1; i <= nr; i++) {
 			if (core_on_status & (BIT(i - 1))) {
 				if (is_secondary_core_off(i) == 1) {
 					printf("core %d powered off\n", i);
@@ -166,16 +184,64 @@ int do_runmulticore(cmd_tbl_t *cmdtp,
 				}
 			}
 		}
-		mdelay(1000);
-		delay++;
-		if (delay > 5)
-			panic("Some cores can't be powered off\n");
+		if (!core_on_status)
+			break;
+		if (delay++ >= CPU_DOWN_TIMEOUT_MS) {
+			printf("Some cores can't be powered off\n");
+			break;
+		}
+		mdelay(1);
 	}
 
-	/* Free up all the stack */
-	for (i = 1; i < argc; i++) {
-		free(core[i - 1].stack_top_ptr);
+	/* Free up the stacks of the cores that are off */
+	for (i = 1; i <= nr; i++) {
+		if (!(core_on_status & BIT(i - 1)))
+			free(core[i - 1].stack_top_ptr);
 	}
+	nr_cores_up = 0;
+
+	invalidate_dcache_all();
+	dcache_enable();
+
+	if (core_on_status)
+		return -ETIMEDOUT;
+	return failed ? -1 : 0;
+}
+
+int do_runmulticore(cmd_tbl_t *cmdtp,
+			   int flag, int argc, char *const argv[])
+{
+	int i;
+	int core_status = 0;
+
+	if ((argc <= 1) || (argc > 4))
+		return CMD_RET_USAGE;
+
+	if (multicore_start(argc - 1, argv + 1)) {
+		multicore_finish();
+		return CMD_RET_FAILURE;
+	}
+
+	for (i = 1; i < argc; i++)
+		core_status |= (BIT(i - 1));
+
+	/* Waiting for secondary cores to complete the task */
+	while (core_status) {
+		for (i = 1; i < argc; i++) {
+			if ((core_status & (BIT(i - 1))) &&
+					multicore_done(i)) {
+				printf("Command on core %d is %s\n", i,
+					(core[i - 1].cmd_result == -1) ?
+					"FAIL" : "PASS");
+				core_status &= (~BIT((i - 1)));
+			}
+		}
+		if (ctrlc()) {
+			run_command("reset", 0);
+		}
+	}
+
+	multicore_finish();
 
 	printf("Status:\n");
 	for (i = 1; i < argc; i++) {
@@ -185,9 +251,6 @@ int do_runmulticore(cmd_tbl_t *cmdtp,
 				 "FAIL" : "PASS"): "INCOMPLETE");
 	}
 
-	invalidate_dcache_all();
-	dcache_enable();
-
 	return CMD_RET_SUCCESS;
 }
 
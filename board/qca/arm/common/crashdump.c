@@ -18,6 +18,12 @@
 #include <spi_flash.h>
 #include <usb.h>
 #include <fat.h>
+#include <malloc.h>
+#include <net.h>
+#include <watchdog.h>
+#ifdef CONFIG_GZIP_COMPRESSED
+#include <u-boot/zlib.h>
+#endif
 #include <asm/errno.h>
 #include <asm/io.h>
 #include <asm/arch-qca-common/scm.h>
@@ -168,6 +174,130 @@ static struct crashdump_flash_emmc_cxt crashdump_emmc_cnxt;
 static struct qca_wdt_crashdump_data g_crashdump_data;
 struct qca_wdt_scm_tlv_msg tlv_msg ;
 
+/*
+ * Compressed dump format, selected with dump_compressed=2:
+ *
+ *   struct zdump_hdr
+ *   chunk data, ZDUMP_CHUNK_SIZE bytes of memory each before compression
+ *   struct zdump_index_ent[nr_chunks]
+ *   struct zdump_trailer
+ *
+ * All-zero chunks are not stored at all, other chunks are stored as an
+ * independent raw deflate stream or, if that does not shrink them, as is.
+ * The index is written last so the file can be produced in a single pass
+ * and streamed straight to the destination.
+ */
+#define ZDUMP_MAGIC			0x31445A51	/* "QZD1" */
+#define ZDUMP_VERSION			1
+#define ZDUMP_CHUNK_SIZE		(64 << 10)
+#define ZDUMP_STAGE_SIZE		(2 * ZDUMP_CHUNK_SIZE)
+#define ZDUMP_MEM_LEVEL			6
+#define ZDUMP_WINDOW_BITS		12
+#define ZDUMP_SUFFIX			".qz"
+/* USB output is staged in memory and written as numbered parts */
+#define ZDUMP_USB_PART_SIZE		(16 << 20)
+
+#define ZDUMP_CHUNK_ZERO		0
+#define ZDUMP_CHUNK_RAW			1
+#define ZDUMP_CHUNK_DEFLATE		2
+
+/* dump_compressed value selecting this format, 1 is gzip of DDR only */
+#define ZDUMP_COMPRESS_MODE		2
+
+#define ZDUMP_DST_TFTP			0
+#define ZDUMP_DST_USB			1
+#define ZDUMP_DST_MEM			2
+#define ZDUMP_DST_NVMEM			3
+
+struct zdump_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t chunk_size;
+	uint32_t nr_chunks;
+	uint32_t addr;
+	uint32_t size;
+};
+
+struct zdump_index_ent {
+	uint32_t offset;
+	uint32_t len;
+	uint32_t type;
+};
+
+struct zdump_trailer {
+	uint32_t index_offset;
+	uint32_t magic;
+};
+
+struct zdump_packer {
+#ifdef CONFIG_GZIP_COMPRESSED
+	z_stream z;
+	int have_z;
+#endif
+};
+
+struct zdump_stream {
+	uint32_t addr;
+	uint32_t size;
+	uint32_t nr_chunks;
+	uint32_t next_chunk;
+	uint32_t index_offset;
+	uint32_t index_sent;
+	int trailer_sent;
+	struct zdump_index_ent *index;
+	/* Generated bytes [stage_base, stage_base + stage_len) */
+	unsigned char *stage;
+	ulong stage_base;
+	unsigned int stage_len;
+	/* Bytes before this offset are no longer needed by the reader */
+	ulong keep_from;
+	ulong out_size;
+	struct zdump_packer packer;
+};
+
+static struct zdump_stream zdump;
+
+#ifdef CONFIG_SMP_CMD_SUPPORT
+/*
+ * With enough chunks in a segment, secondary cores compress them while
+ * the primary core sends what is ready. Worker n packs chunks n, n + w,
+ * n + 2w, ... into its own slots in turn, so each slot has one writer
+ * and one reader and needs no locking.
+ */
+#define ZDUMP_MAX_WORKERS		(NR_CPUS - 1)
+#define ZDUMP_WORKER_SLOTS		2
+#define ZDUMP_MIN_PIPE_CHUNKS		16
+/* Far more than a chunk takes, even packed from uncached memory */
+#define ZDUMP_WORKER_TIMEOUT_MS		5000
+
+#define ZDUMP_SLOT_FREE			0
+#define ZDUMP_SLOT_READY		1
+
+struct zdump_slot {
+	volatile uint32_t state;
+	uint32_t len;
+	uint32_t type;
+	unsigned char *data;
+};
+
+struct zdump_worker {
+	struct zdump_packer packer;
+	struct zdump_slot slot[ZDUMP_WORKER_SLOTS];
+	char cmd[16];
+};
+
+static struct {
+	volatile int nr_workers;
+	volatile int abort;
+	struct zdump_worker worker[ZDUMP_MAX_WORKERS];
+} zdump_pipe;
+#endif
+
+/* Text list of the files written, sent last when the dump is compressed */
+#define ZDUMP_MANIFEST_SIZE		4096
+static char *zdump_manifest;
+static int zdump_manifest_len;
+
 static ulong dump2mem_addr_curr = 0, dump2mem_addr = 0, dump2mem_addr_limit =0;
 static uint32_t dumplist_entrymax = DEFAULT_MINIDUMP_LIST_ENTRY_MAX;
 static struct memdump_hdr dump2mem_hdr;
@@ -217,12 +347,535 @@ static int krait_release_secondary(void)
 	return 0;
 }
 
+#ifdef CONFIG_GZIP_COMPRESSED
+static void *zdump_zalloc(void *x, unsigned items, unsigned size)
+{
+	return malloc(items * size);
+}
+
+static void zdump_zfree(void *x, void *addr, unsigned nb)
+{
+	free(addr);
+}
+#endif
+
+static void zdump_packer_init(struct zdump_packer *pk)
+{
+#ifdef CONFIG_GZIP_COMPRESSED
+	memset(&pk->z, 0, sizeof(pk->z));
+	pk->z.zalloc = zdump_zalloc;
+	pk->z.zfree = zdump_zfree;
+	pk->z.opaque = Z_NULL;
+	/* Failing here only costs compression, zero elision still works */
+	pk->have_z = deflateInit2_(&pk->z, Z_BEST_SPEED, Z_DEFLATED,
+			-ZDUMP_WINDOW_BITS, ZDUMP_MEM_LEVEL, Z_DEFAULT_STRATEGY,
+			ZLIB_VERSION, sizeof(z_stream)) == Z_OK;
+#endif
+}
+
+static void zdump_packer_end(struct zdump_packer *pk)
+{
+#ifdef CONFIG_GZIP_COMPRESSED
+	if (pk->have_z)
+		deflateEnd(&pk->z);
+	pk->have_z = 0;
+#endif
+}
+
+static int zdump_is_zero(const unsigned char *buf, unsigned int len)
+{
+	const unsigned char *end = buf + len;
+
+	while (buf < end && ((ulong)buf & (sizeof(ulong) - 1)))
+		if (*buf++)
+			return 0;
+
+	for (; buf + sizeof(ulong) <= end; buf += sizeof(ulong))
+		if (*(const ulong *)buf)
+			return 0;
+
+	while (buf < end)
+		if (*buf++)
+			return 0;
+
+	return 1;
+}
+
+/* Store one chunk at dst, which has room for len bytes */
+static unsigned int zdump_pack_chunk(struct zdump_packer *pk, unsigned char *dst,
+		const unsigned char *src, unsigned int len, uint32_t *type)
+{
+	if (zdump_is_zero(src, len)) {
+		*type = ZDUMP_CHUNK_ZERO;
+		return 0;
+	}
+
+#ifdef CONFIG_GZIP_COMPRESSED
+	if (pk->have_z) {
+		deflateReset(&pk->z);
+		pk->z.next_in = (unsigned char *)src;
+		pk->z.avail_in = len;
+		pk->z.next_out = dst;
+		/* Anything not smaller than the input is stored raw */
+		pk->z.avail_out = len - 1;
+		if (deflate(&pk->z, Z_FINISH) == Z_STREAM_END) {
+			*type = ZDUMP_CHUNK_DEFLATE;
+			return len - 1 - pk->z.avail_out;
+		}
+	}
+#endif
+
+	memcpy(dst, src, len);
+	*type = ZDUMP_CHUNK_RAW;
+	return len;
+}
+
+static const unsigned char *zdump_chunk_src(struct zdump_stream *zs,
+		uint32_t chunk, unsigned int *len)
+{
+	uint32_t off = chunk * ZDUMP_CHUNK_SIZE;
+
+	*len = min_t(uint32_t, zs->size - off, ZDUMP_CHUNK_SIZE);
+	return (const unsigned char *)(zs->addr + off);
+}
+
+#ifdef CONFIG_SMP_CMD_SUPPORT
+static void zdump_pipe_free(void)
+{
+	int i, j;
+
+	for (i = 0; i < ZDUMP_MAX_WORKERS; i++) {
+		struct zdump_worker *w = &zdump_pipe.worker[i];
+
+		zdump_packer_end(&w->packer);
+		for (j = 0; j < ZDUMP_WORKER_SLOTS; j++) {
+			free(w->slot[j].data);
+			w->slot[j].data = NULL;
+		}
+	}
+	zdump_pipe.nr_workers = 0;
+}
+
+static void zdump_pipe_stop(void)
+{
+	if (!zdump_pipe.nr_workers)
+		return;
+
+	zdump_pipe.abort = 1;
+	/* A core that did not stop may still write to its slots, keep them */
+	if (multicore_finish()) {
+		zdump_pipe.nr_workers = 0;
+		return;
+	}
+	zdump_pipe_free();
+}
+
+/* Hand zs to the secondary cores, stays single core if that fails */
+static void zdump_pipe_start(struct zdump_stream *zs)
+{
+	char *cmds[ZDUMP_MAX_WORKERS];
+	int j, nr;
+
+	if (zs->nr_chunks < ZDUMP_MIN_PIPE_CHUNKS)
+		return;
+
+	memset(&zdump_pipe, 0, sizeof(zdump_pipe));
+	/* Everything is allocated here, workers must not touch the heap */
+	for (nr = 0; nr < ZDUMP_MAX_WORKERS; nr++) {
+		struct zdump_worker *w = &zdump_pipe.worker[nr];
+
+		for (j = 0; j < ZDUMP_WORKER_SLOTS; j++)
+			w->slot[j].data = malloc(ZDUMP_CHUNK_SIZE);
+		if (!w->slot[ZDUMP_WORKER_SLOTS - 1].data)
+			break;
+		zdump_packer_init(&w->packer);
+		snprintf(w->cmd, sizeof(w->cmd), "dumpworker %d", nr);
+		cmds[nr] = w->cmd;
+	}
+
+	if (!nr) {
+		zdump_pipe_free();
+		return;
+	}
+
+	if (multicore_start(nr, cmds)) {
+		/* Let the workers that did come up return, then go on alone */
+		zdump_pipe.abort = 1;
+		if (!multicore_finish())
+			zdump_pipe_free();
+		return;
+	}
+
+	zdump_pipe.nr_workers = nr;
+}
+
+/*
+ * Collect the packed chunk from the worker that owns it. If the worker
+ * stops making progress, the pipeline is torn down and the chunk (and
+ * every one after it) is packed on this core instead.
+ */
+static unsigned int zdump_pipe_take(struct zdump_stream *zs, uint32_t chunk,
+		unsigned char *dst, uint32_t *type)
+{
+	int nr = zdump_pipe.nr_workers;
+	struct zdump_worker *w = &zdump_pipe.worker[chunk % nr];
+	struct zdump_slot *slot = &w->slot[(chunk / nr) % ZDUMP_WORKER_SLOTS];
+	const unsigned char *src;
+	unsigned int len;
+	ulong start = get_timer(0);
+
+	while (slot->state != ZDUMP_SLOT_READY) {
+		WATCHDOG_RESET();
+		if (get_timer(start) > ZDUMP_WORKER_TIMEOUT_MS) {
+			printf("\nWarning: dump worker %d stuck, going on single core\n",
+					chunk % nr);
+			zdump_pipe_stop();
+			src = zdump_chunk_src(zs, chunk, &len);
+			return zdump_pack_chunk(&zs->packer, dst, src, len, type);
+		}
+	}
+	/* Pairs with the worker's dmb() before it marks the slot ready */
+	dmb();
+
+	len = slot->len;
+	*type = slot->type;
+	memcpy(dst, slot->data, len);
+	dmb();
+	slot->state = ZDUMP_SLOT_FREE;
+
+	return len;
+}
+
+static int do_dump_worker(cmd_tbl_t *cmdtp, int flag, int argc,
+		char *const argv[])
+{
+	int nr = zdump_pipe.nr_workers;
+	struct zdump_worker *w;
+	struct zdump_slot *slot;
+	const unsigned char *src;
+	unsigned int len;
+	uint32_t chunk;
+	int id;
+
+	if (!(flag & CMD_FLAG_SEC_CORE) || argc != 2)
+		return CMD_RET_USAGE;
+
+	/* nr_workers is only set once every core is up */
+	while (!(nr = zdump_pipe.nr_workers))
+		if (zdump_pipe.abort)
+			return CMD_RET_SUCCESS;
+
+	id = simple_strtoul(argv[1], NULL, 10);
+	w = &zdump_pipe.worker[id];
+
+	for (chunk = id; chunk < zdump.nr_chunks; chunk += nr) {
+		slot = &w->slot[(chunk / nr) % ZDUMP_WORKER_SLOTS];
+		while (slot->state != ZDUMP_SLOT_FREE)
+			if (zdump_pipe.abort)
+				return CMD_RET_SUCCESS;
+
+		src = zdump_chunk_src(&zdump, chunk, &len);
+		slot->len = zdump_pack_chunk(&w->packer, slot->data, src, len,
+				&slot->type);
+		dmb();
+		slot->state = ZDUMP_SLOT_READY;
+	}
+
+	return CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(dumpworker, 2, 0, do_dump_worker,
+	   "crash dump compression worker",
+	   "<n> - run by the crash dumper on secondary cores");
+#endif
+
+static void zdump_rewind(struct zdump_stream *zs)
+{
+	struct zdump_hdr *hdr = (struct zdump_hdr *)zs->stage;
+
+#ifdef CONFIG_SMP_CMD_SUPPORT
+	/* Workers only run forward, start over on this core */
+	zdump_pipe_stop();
+#endif
+
+	zs->next_chunk = 0;
+	zs->index_sent = 0;
+	zs->trailer_sent = 0;
+	zs->stage_base = 0;
+	zs->keep_from = 0;
+
+	hdr->magic = ZDUMP_MAGIC;
+	hdr->version = ZDUMP_VERSION;
+	hdr->chunk_size = ZDUMP_CHUNK_SIZE;
+	hdr->nr_chunks = zs->nr_chunks;
+	hdr->addr = zs->addr;
+	hdr->size = zs->size;
+	zs->stage_len = sizeof(*hdr);
+	zs->out_size = sizeof(*hdr);
+}
+
+static void zdump_close(struct zdump_stream *zs)
+{
+#ifdef CONFIG_SMP_CMD_SUPPORT
+	zdump_pipe_stop();
+#endif
+	zdump_packer_end(&zs->packer);
+	free(zs->index);
+	free(zs->stage);
+	zs->index = NULL;
+	zs->stage = NULL;
+}
+
+static int zdump_open(struct zdump_stream *zs, uint32_t addr, uint32_t size)
+{
+	memset(zs, 0, sizeof(*zs));
+	zs->addr = addr;
+	zs->size = size;
+	zs->nr_chunks = DIV_ROUND_UP(size, ZDUMP_CHUNK_SIZE);
+	zs->index = malloc(zs->nr_chunks * sizeof(struct zdump_index_ent));
+	zs->stage = malloc(ZDUMP_STAGE_SIZE);
+	if (!zs->index || !zs->stage) {
+		printf("Error: no memory for dump compression\n");
+		zdump_close(zs);
+		return -ENOMEM;
+	}
+
+	zdump_packer_init(&zs->packer);
+	zdump_rewind(zs);
+#ifdef CONFIG_SMP_CMD_SUPPORT
+	zdump_pipe_start(zs);
+#endif
+	return 0;
+}
+
+/* Append the next piece of the file to the stage, returns 0 at the end */
+static int zdump_fill(struct zdump_stream *zs)
+{
+	unsigned char *dst;
+	unsigned int room, len;
+
+	if (ZDUMP_STAGE_SIZE - zs->stage_len < ZDUMP_CHUNK_SIZE) {
+		unsigned int drop = zs->keep_from - zs->stage_base;
+
+		memmove(zs->stage, zs->stage + drop, zs->stage_len - drop);
+		zs->stage_len -= drop;
+		zs->stage_base += drop;
+	}
+
+	dst = zs->stage + zs->stage_len;
+	room = ZDUMP_STAGE_SIZE - zs->stage_len;
+
+	if (zs->next_chunk < zs->nr_chunks) {
+		struct zdump_index_ent *ent = &zs->index[zs->next_chunk];
+		const unsigned char *src;
+
+		ent->offset = zs->out_size;
+#ifdef CONFIG_SMP_CMD_SUPPORT
+		if (zdump_pipe.nr_workers) {
+			ent->len = zdump_pipe_take(zs, zs->next_chunk, dst,
+					&ent->type);
+		} else
+#endif
+		{
+			src = zdump_chunk_src(zs, zs->next_chunk, &len);
+			ent->len = zdump_pack_chunk(&zs->packer, dst, src, len,
+					&ent->type);
+		}
+		len = ent->len;
+		if (++zs->next_chunk == zs->nr_chunks)
+			zs->index_offset = zs->out_size + len;
+		WATCHDOG_RESET();
+	} else if (zs->index_sent < zs->nr_chunks * sizeof(struct zdump_index_ent)) {
+		len = min_t(unsigned int, room, zs->nr_chunks *
+				sizeof(struct zdump_index_ent) - zs->index_sent);
+		memcpy(dst, (unsigned char *)zs->index + zs->index_sent, len);
+		zs->index_sent += len;
+	} else if (!zs->trailer_sent) {
+		struct zdump_trailer trailer = {
+			.index_offset = zs->index_offset,
+			.magic = ZDUMP_MAGIC,
+		};
+
+		len = sizeof(trailer);
+		memcpy(dst, &trailer, len);
+		zs->trailer_sent = 1;
+	} else {
+		return 0;
+	}
+
+	zs->stage_len += len;
+	zs->out_size += len;
+	return 1;
+}
+
+/*
+ * Copy up to len bytes of the file starting at offset. Reads must not go
+ * back beyond the previous read, except to offset 0 which starts over.
+ */
+static int zdump_read(struct zdump_stream *zs, ulong offset,
+		unsigned char *dst, unsigned int len)
+{
+	if (offset < zs->keep_from) {
+		if (offset)
+			return -EINVAL;
+		zdump_rewind(zs);
+	}
+
+	/* The stage holds two chunks, one is kept for the reader */
+	len = min_t(unsigned int, len, ZDUMP_CHUNK_SIZE);
+	zs->keep_from = offset;
+	while (zs->stage_base + zs->stage_len < offset + len)
+		if (!zdump_fill(zs))
+			break;
+
+	if (offset >= zs->stage_base + zs->stage_len)
+		return 0;
+
+	len = min_t(ulong, len, zs->stage_base + zs->stage_len - offset);
+	memcpy(dst, zs->stage + (offset - zs->stage_base), len);
+	return len;
+}
+
+#ifdef CONFIG_CMD_TFTPPUT
+static int zdump_tftp_source(ulong offset, uchar *dst, unsigned len)
+{
+	return zdump_read(&zdump, offset, dst, len);
+}
+#endif
+
+/*
+ * Compress memaddr/size to dst. ZDUMP_DST_MEM stores at mem, with at most
+ * limit bytes available; ZDUMP_DST_NVMEM has the same limit on what is
+ * written to the partition. The compressed size is returned in out_size.
+ */
+static int zdump_to_dst(uint32_t memaddr, uint32_t size, char *name,
+		int dst, ulong mem, ulong limit, ulong *out_size)
+{
+	unsigned char *buf = (unsigned char *)IPQ_TEMP_DUMP_ADDR;
+	unsigned char probe;
+	char runcmd[256];
+	ulong done = 0;
+	int part = 0, len, fill;
+	int ret = CMD_RET_SUCCESS;
+
+	if (zdump_open(&zdump, memaddr, size))
+		return CMD_RET_FAILURE;
+
+	if (dst == ZDUMP_DST_MEM) {
+		while (done < limit && (len = zdump_read(&zdump, done,
+				(unsigned char *)mem + done,
+				min_t(ulong, limit - done, ZDUMP_CHUNK_SIZE))) > 0)
+			done += len;
+		/* Out of room if anything is left */
+		if (zdump_read(&zdump, done, &probe, 1) > 0)
+			ret = CMD_RET_FAILURE;
+	} else if (dst == ZDUMP_DST_NVMEM) {
+		/* The flash writers do not check the partition end */
+		buf = malloc(ZDUMP_CHUNK_SIZE);
+		while (buf && done < limit && (len = zdump_read(&zdump, done,
+				buf, min_t(ulong, limit - done,
+					   ZDUMP_CHUNK_SIZE))) > 0) {
+			if (crashdump_flash_write(crashdump_cnxt, buf, len)) {
+				ret = CMD_RET_FAILURE;
+				break;
+			}
+			done += len;
+		}
+		/* Out of room if anything is left */
+		if (!buf || zdump_read(&zdump, done, &probe, 1) > 0)
+			ret = CMD_RET_FAILURE;
+		free(buf);
+	} else if (dst == ZDUMP_DST_USB) {
+		/*
+		 * FAT cannot append, so the file is written in parts staged
+		 * in the same scratch area used for aligned copies, past the
+		 * copy if this segment is one.
+		 */
+		if (memaddr == IPQ_TEMP_DUMP_ADDR)
+			buf += roundup(size, ARCH_DMA_MINALIGN);
+		do {
+			for (fill = 0; fill < ZDUMP_USB_PART_SIZE; fill += len) {
+				len = zdump_read(&zdump, done + fill, buf + fill,
+					min(ZDUMP_CHUNK_SIZE, ZDUMP_USB_PART_SIZE - fill));
+				if (len <= 0)
+					break;
+			}
+			if (!fill)
+				break;
+
+			snprintf(runcmd, sizeof(runcmd), "fatwrite usb %x:%x 0x%x %s"
+					ZDUMP_SUFFIX ".%03d 0x%x", usb_dev_indx,
+					usb_dev_part, (uint32_t)buf, name, part++, fill);
+			if (run_command(runcmd, 0) != CMD_RET_SUCCESS) {
+				ret = CMD_RET_FAILURE;
+				break;
+			}
+			done += fill;
+		} while (fill == ZDUMP_USB_PART_SIZE);
+	} else {
+#ifdef CONFIG_CMD_TFTPPUT
+		char *dumpdir = getenv("dumpdir");
+		ulong worst;
+
+		/* Only an upper bound, the transfer ends with the data */
+		worst = sizeof(struct zdump_hdr) + size + zdump.nr_chunks *
+			sizeof(struct zdump_index_ent) + sizeof(struct zdump_trailer);
+		snprintf(runcmd, sizeof(runcmd), "tftpput 0x%x 0x%lx %s/%s"
+				ZDUMP_SUFFIX, memaddr, worst,
+				dumpdir ? dumpdir : "", name);
+		tftp_put_source = zdump_tftp_source;
+		if (run_command(runcmd, 0) != CMD_RET_SUCCESS)
+			ret = CMD_RET_FAILURE;
+		tftp_put_source = NULL;
+		done = zdump.out_size;
+#else
+		ret = CMD_RET_FAILURE;
+#endif
+	}
+
+	if (ret == CMD_RET_SUCCESS) {
+		printf("%s: 0x%x bytes stored in 0x%lx\n", name, size, done);
+		if (zdump_manifest && zdump_manifest_len < ZDUMP_MANIFEST_SIZE)
+			zdump_manifest_len += snprintf(zdump_manifest + zdump_manifest_len,
+					ZDUMP_MANIFEST_SIZE - zdump_manifest_len,
+					"%s" ZDUMP_SUFFIX " 0x%08x 0x%08x 0x%08lx\n",
+					name, memaddr, size, done);
+	}
+	*out_size = done;
+
+	zdump_close(&zdump);
+	return ret;
+}
+
+/* Send the list of compressed files, one "name addr size stored" per line */
+static int zdump_write_manifest(int is_usb_dump)
+{
+	char runcmd[256];
+	char *dumpdir = getenv("dumpdir");
+	int len = min(zdump_manifest_len, ZDUMP_MANIFEST_SIZE - 1);
+
+	if (is_usb_dump == 1)
+		snprintf(runcmd, sizeof(runcmd), "fatwrite usb %x:%x 0x%x %sMANIFEST.TXT 0x%x",
+				usb_dev_indx, usb_dev_part, (uint32_t)zdump_manifest,
+				dump_prefix, len);
+	else
+		snprintf(runcmd, sizeof(runcmd), "tftpput 0x%x 0x%x %s/%sMANIFEST.TXT",
+				(uint32_t)zdump_manifest, len,
+				dumpdir ? dumpdir : "", dump_prefix);
+
+	if (run_command(runcmd, 0) != CMD_RET_SUCCESS)
+		return CMD_RET_FAILURE;
+
+	return CMD_RET_SUCCESS;
+}
+
 static int dump_to_dst (int is_aligned_access, uint32_t memaddr, uint32_t size, char *name,
 		unsigned int dump_level)
 {
 	char runcmd[256];
 	char *usb_dump = NULL, *dump2mem = NULL, *dump2nvmem = NULL;
-	ulong is_usb_dump = 0;
+	char *compress = NULL;
+	ulong is_usb_dump = 0, is_compress = 0, zsize;
 	int ret = 0;
 
 	if (!size) {
@@ -241,6 +894,10 @@ static int dump_to_dst (int is_aligned_access, uint32_t memaddr, uint32_t size,
 		}
 	}
 
+	compress = getenv("dump_compressed");
+	if (compress && !str2long(compress, &is_compress))
+		is_compress = 0;
+
 	if (is_aligned_access) {
 		if (IPQ_TEMP_DUMP_ADDR) {
 			snprintf(runcmd, sizeof(runcmd), "cp.l 0x%x 0x%x 0x%x", memaddr,
@@ -255,10 +912,14 @@ static int dump_to_dst (int is_aligned_access, uint32_t memaddr, uint32_t size,
 		}
 	}
 
-	if (is_usb_dump == 1)
+	if (is_usb_dump == 1) {
+		if (is_compress == ZDUMP_COMPRESS_MODE)
+			return zdump_to_dst(memaddr, size, name, ZDUMP_DST_USB,
+					0, 0, &zsize);
+
 		snprintf(runcmd, sizeof(runcmd), "fatwrite usb %x:%x 0x%x %s 0x%x",
 					usb_dev_indx, usb_dev_part, memaddr, name, size);
-	else if (dump2mem && (dump_level == MINIMAL_DUMP)) {
+	} else if (dump2mem && (dump_level == MINIMAL_DUMP)) {
 		int idx = dump2mem_hdr.nos_dumps++;
 
 		if (idx >= dumplist_entrymax) {
@@ -274,6 +935,23 @@ static int dump_to_dst (int is_aligned_access, uint32_t memaddr, uint32_t size,
 		strlcpy(dumps_list[idx].name, name, sizeof(dumps_list[idx].name));
 		dumps_list[idx].offset = dump2mem_addr_curr - dump2mem_addr;
 		dumps_list[idx].size = size;
+
+		if (is_compress == ZDUMP_COMPRESS_MODE) {
+			printf("Dumping %s @ 0x%lX \n", dumps_list[idx].name, dump2mem_addr_curr);
+			ret = zdump_to_dst(memaddr, size, name, ZDUMP_DST_MEM,
+					dump2mem_addr_curr,
+					dump2mem_addr_limit - dump2mem_addr_curr, &zsize);
+			if (ret != CMD_RET_SUCCESS) {
+				printf("Error: Not enough memory in rsvd mem to save dumps\n");
+				return ret;
+			}
+
+			dump2mem_hdr.reserved[0] = ZDUMP_MAGIC;
+			dumps_list[idx].size = zsize;
+			dump2mem_addr_curr = roundup(dump2mem_addr_curr + zsize, ARCH_DMA_MINALIGN);
+			return CMD_RET_SUCCESS;
+		}
+
 		snprintf(runcmd, sizeof(runcmd), "cp.l 0x%x 0x%lx 0x%x",
 				memaddr, dump2mem_addr_curr, size);
 
@@ -302,6 +980,23 @@ static int dump_to_dst (int is_aligned_access, uint32_t memaddr, uint32_t size,
 		dumps_list[idx].offset = dump2mem_addr_curr;
 		dumps_list[idx].size = size;
 
+		if (is_compress == ZDUMP_COMPRESS_MODE) {
+			printf("Writing %s in %s @ offset 0x%lx\n", dumps_list[idx].name,
+					dump2nvmem, dump2mem_addr_curr);
+			ret = zdump_to_dst(memaddr, size, name, ZDUMP_DST_NVMEM,
+					0, dump2nvmem_info.size - dump2mem_addr_curr,
+					&zsize);
+			if (ret != CMD_RET_SUCCESS) {
+				printf("Error: Not enough memory in %s partition to save dumps\n", dump2nvmem);
+				return ret;
+			}
+
+			dump2mem_hdr.reserved[0] = ZDUMP_MAGIC;
+			dumps_list[idx].size = zsize;
+			dump2mem_addr_curr += zsize;
+			return CMD_RET_SUCCESS;
+		}
+
 		if (dump2mem_addr_curr + size > dump2nvmem_info.size) {
 			printf("Error: Not enough memory in %s partition to save dumps\n", dump2nvmem);
 			return CMD_RET_FAILURE;
@@ -326,6 +1021,10 @@ static int dump_to_dst (int is_aligned_access, uint32_t memaddr, uint32_t size,
 			printf("Env 'dumpdir' not set. Using / dir in TFTP server\n");
 		}
 
+		if (is_compress == ZDUMP_COMPRESS_MODE)
+			return zdump_to_dst(memaddr, size, name, ZDUMP_DST_TFTP,
+					0, 0, &zsize);
+
 		snprintf(runcmd, sizeof(runcmd), "tftpput 0x%x 0x%x %s/%s",
 						memaddr, size, dumpdir, name);
 	}
@@ -756,6 +1455,16 @@ static int do_dumpqca_data(unsigned int dump_level)
 	else
 		dump_prefix = "";
 
+	/* Memory and flash minidumps already carry their own list */
+	compress = getenv("dump_compressed");
+	if (compress && str2long(compress, &is_compress) &&
+			is_compress == ZDUMP_COMPRESS_MODE &&
+			!((getenv("dump_to_mem") || dump2nvmem) &&
+			  (dump_level == MINIMAL_DUMP))) {
+		zdump_manifest = malloc(ZDUMP_MANIFEST_SIZE);
+		zdump_manifest_len = 0;
+	}
+
 	if (scm_set_boot_addr(false) == 0) {
 		/* Pull Core-1 out of reset, iff scm call succeeds */
 		krait_release_secondary();
@@ -908,6 +1617,13 @@ static int do_dumpqca_data(unsigned int dump_level)
 	}
 
 stop_dump:
+	if (zdump_manifest) {
+		if (ret == CMD_RET_SUCCESS && zdump_manifest_len)
+			ret = zdump_write_manifest(is_usb_dump);
+		free(zdump_manifest);
+		zdump_manifest = NULL;
+	}
+
 	if (getenv("dump_to_mem") && (dump_level == MINIMAL_DUMP)) {
 		if (ret != CMD_RET_SUCCESS)
 			return ret;
@@ -1000,7 +1716,9 @@ void dump_func(unsigned int dump_level)
 	char *serverip = NULL, *forced_dump = NULL;
 	char runcmd[50] = {0};
 
-#ifdef CONFIG_IPQ_ETH_INIT_DEFER
+#if defined(CONFIG_IPQ_LAZY_INIT)
+	ipq_lazy_init(IPQ_LAZY_NET);
+#elif defined(CONFIG_IPQ_ETH_INIT_DEFER)
 	puts("\nNet:   ");
 	eth_initialize();
 #endif
@@ -1091,6 +1091,7 @@ int ft_board_setup(void *blob, bd_t *bd)
 		{ NULL, 0, -1 },	/* Terminator */
 	};
 #endif
+	bootstage_mark_name(BOOTSTAGE_ID_FDT_FIXUP, "fdt_fixup");
 	fdt_fixup_memory_banks(blob, &memory_start, &memory_size, 1);
 	ipq_fdt_fixup_version(blob);
 #if !defined(CONFIG_QCA_APPSBL_DLOAD) && defined(CONFIG_IPQ_FDT_FIXUP)
@@ -1161,7 +1162,6 @@ int ft_board_setup(void *blob, bd_t *bd)
 	}
 #endif
 
-	dcache_disable();
 	ipq_fdt_fixup_socinfo(blob);
 #ifdef CONFIG_IPQ_FDT_FIXUP
 	s = (getenv("gmacnumber"));
@@ -1209,11 +1209,21 @@ int ft_board_setup(void *blob, bd_t *bd)
 	*/
 	fdt_fixup_art_format(blob);
 
+	/*
+	 * The fixups above are plain memory work and run with the data
+	 * cache on; only turn it off for the hand-off to the kernel.
+	 */
+	dcache_disable();
 #ifdef CONFIG_QCA_MMC
 	board_mmc_deinit();
 #endif
 
 	fdt_fixup_ethernet(blob);
+	bootstage_mark_name(BOOTSTAGE_ID_FDT_FIXUP_DONE, "fdt_fixup_done");
+#ifdef CONFIG_BOOTSTAGE_FDT
+	/* Hand the timings recorded so far to Linux */
+	bootstage_fdt_add(blob);
+#endif
 	return 0;
 }
 
@@ -0,0 +1,518 @@
+/*
+ * Copyright (c) 2020 The Linux Foundation. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <hash.h>
+#include <image.h>
+#include <malloc.h>
+#include <mmc.h>
+#include <spi.h>
+#include <spi_flash.h>
+#ifdef CONFIG_CMD_UBI
+#include <ubi_uboot.h>
+#endif
+#include <asm/arch-qca-common/qca_common.h>
+
+/*
+ * Reads the HLOS image from its partition. A FIT is read in two passes:
+ * first its metadata, skipping over large properties, then the skipped
+ * image data in chunks, hashing each chunk while the next one is read.
+ * The hashes that match are handed to fit_image_hash_set_verified() so
+ * bootm does not walk the data again. Only the bytes of the image are
+ * read, not the whole partition; legacy images are sized from their
+ * header, and either kind may sit behind an mbn header.
+ */
+
+#define HLOS_META_WINDOW	4096	/* metadata read granularity */
+#define HLOS_BIG_PROP		1024	/* larger properties are streamed */
+#define HLOS_NAME_MAX		256	/* longest node name looked for */
+#define HLOS_CHUNK		(1 << 20)
+#define HLOS_EXTENTS_INIT	16	/* doubled as needed, one per big prop */
+#define HLOS_MAX_HASHES		FIT_MAX_PREVERIFIED
+
+typedef struct {
+	unsigned int image_type;
+	unsigned int header_vsn_num;
+	unsigned int image_src;
+	unsigned char *image_dest_ptr;
+	unsigned int image_size;
+	unsigned int code_size;
+	unsigned char *signature_ptr;
+	unsigned int signature_size;
+	unsigned char *cert_chain_ptr;
+	unsigned int cert_chain_size;
+} mbn_header_t;
+
+struct hlos_extent {
+	ulong off;
+	ulong len;
+};
+
+struct hlos_hash {
+	ulong off;		/* image data covered by this hash node */
+	ulong len;
+	int noffset;
+	struct hash_algo *algo;
+	void *ctx;
+};
+
+struct hlos_fit {
+	struct hlos_src *src;
+	uint8_t *load;		/* start of the partition in memory */
+	ulong base;		/* FIT offset in the partition */
+	uint8_t *dst;		/* load + base */
+	ulong size;		/* FIT total size */
+	ulong win_start;	/* metadata currently loaded */
+	ulong win_end;
+	int nr_extents;
+	int max_extents;
+	struct hlos_extent *extents;
+	int nr_hashes;
+	struct hlos_hash hashes[HLOS_MAX_HASHES];
+};
+
+static ulong hlos_chunk(struct hlos_src *src)
+{
+	ulong chunk = min_t(ulong, HLOS_CHUNK, src->max_read);
+
+	chunk -= chunk % src->align;
+	return chunk ? chunk : src->align;
+}
+
+/* Synchronous read of [off, off + len), rounded out to the read alignment */
+static int hlos_read(struct hlos_src *src, uint8_t *dst, ulong off, ulong len)
+{
+	ulong end = roundup(off + len, src->align);
+	ulong chunk = hlos_chunk(src);
+	ulong n;
+
+	off = rounddown(off, src->align);
+	end = min(end, src->size);
+	for (; off < end; off += n) {
+		n = min(end - off, chunk);
+		if (src->read_start(src, off, n, dst + off) ||
+		    src->read_finish(src))
+			return -EIO;
+	}
+	return 0;
+}
+
+/* Make [off, off + len) of the FIT metadata available */
+static int hlos_fit_need(struct hlos_fit *h, ulong off, ulong len)
+{
+	ulong start, end;
+
+	/* Written so that a corrupt offset or length cannot wrap */
+	if (off > h->size || len > h->size - off)
+		return -EINVAL;
+	if (off >= h->win_start && off + len <= h->win_end)
+		return 0;
+
+	start = rounddown(h->base + off, h->src->align);
+	end = min(roundup(h->base + off + len, h->src->align) +
+		  HLOS_META_WINDOW, h->base + h->size);
+	if (hlos_read(h->src, h->load, start, end - start))
+		return -EIO;
+	h->win_start = max(start, h->base) - h->base;
+	h->win_end = end - h->base;
+	return 0;
+}
+
+static uint32_t hlos_fit_word(struct hlos_fit *h, ulong off)
+{
+	return fdt32_to_cpu(*(fdt32_t *)(h->dst + off));
+}
+
+/* A multi-DTB FIT has a big property per fdt node, so the list grows */
+static int hlos_fit_add_extent(struct hlos_fit *h, ulong off, ulong len)
+{
+	struct hlos_extent *ext;
+	int max;
+
+	if (h->nr_extents == h->max_extents) {
+		max = h->max_extents ? 2 * h->max_extents : HLOS_EXTENTS_INIT;
+		ext = realloc(h->extents, max * sizeof(*ext));
+		if (!ext)
+			return -ENOMEM;
+		h->extents = ext;
+		h->max_extents = max;
+	}
+
+	h->extents[h->nr_extents].off = off;
+	h->extents[h->nr_extents].len = len;
+	h->nr_extents++;
+	return 0;
+}
+
+/*
+ * Walk the structure block, reading everything but properties larger
+ * than HLOS_BIG_PROP, which are recorded as extents for the second pass.
+ */
+static int hlos_fit_read_meta(struct hlos_fit *h)
+{
+	const struct fdt_header *fdt = (void *)h->dst;
+	ulong p = fdt_off_dt_struct(fdt);
+	ulong strings = fdt_off_dt_strings(fdt);
+	ulong len;
+	const char *name;
+	int ret;
+
+	for (;;) {
+		if (hlos_fit_need(h, p, FDT_TAGSIZE))
+			return -EINVAL;
+
+		switch (hlos_fit_word(h, p)) {
+		case FDT_BEGIN_NODE:
+			p += FDT_TAGSIZE;
+			if (hlos_fit_need(h, p, min_t(ulong, HLOS_NAME_MAX,
+						      h->size - p)))
+				return -EINVAL;
+			name = (const char *)h->dst + p;
+			len = strnlen(name, h->win_end - p);
+			if (p + len >= h->win_end)
+				return -EINVAL;
+			p += ALIGN(len + 1, FDT_TAGSIZE);
+			break;
+		case FDT_PROP:
+			if (hlos_fit_need(h, p, sizeof(struct fdt_property)))
+				return -EINVAL;
+			len = hlos_fit_word(h, p + FDT_TAGSIZE);
+			p += sizeof(struct fdt_property);
+			if (len > HLOS_BIG_PROP) {
+				if (len > h->size - p)
+					return -EINVAL;
+				ret = hlos_fit_add_extent(h, p, len);
+				if (ret)
+					return ret;
+			} else if (hlos_fit_need(h, p, len)) {
+				return -EINVAL;
+			}
+			p += ALIGN(len, FDT_TAGSIZE);
+			break;
+		case FDT_END_NODE:
+		case FDT_NOP:
+			p += FDT_TAGSIZE;
+			break;
+		case FDT_END:
+			/* The strings block follows the structure block */
+			if (strings < h->size &&
+			    hlos_fit_need(h, strings, h->size - strings))
+				return -EINVAL;
+			return 0;
+		default:
+			return -EINVAL;
+		}
+	}
+}
+
+/* Set up a progressive hash for every hash node of every image */
+static void hlos_fit_start_hashes(struct hlos_fit *h)
+{
+	const void *fit = h->dst;
+	struct hlos_hash *hh;
+	const void *data;
+	size_t size;
+	int images, image, noffset;
+	char *algo;
+
+	images = fdt_path_offset(fit, FIT_IMAGES_PATH);
+	if (images < 0)
+		return;
+
+	fdt_for_each_subnode(fit, image, images) {
+		/* Small images are not streamed, bootm hashes them */
+		if (fit_image_get_data(fit, image, &data, &size) ||
+		    size <= HLOS_BIG_PROP)
+			continue;
+
+		fdt_for_each_subnode(fit, noffset, image) {
+			if (strncmp(fit_get_name(fit, noffset, NULL),
+				    FIT_HASH_NODENAME,
+				    strlen(FIT_HASH_NODENAME)))
+				continue;
+			if (h->nr_hashes == HLOS_MAX_HASHES)
+				return;
+			if (fit_image_hash_get_algo(fit, noffset, &algo))
+				continue;
+
+			hh = &h->hashes[h->nr_hashes];
+			if (hash_progressive_lookup_algo(algo, &hh->algo) ||
+			    hh->algo->hash_init(hh->algo, &hh->ctx))
+				continue;
+			hh->off = (const uint8_t *)data - h->dst;
+			hh->len = size;
+			hh->noffset = noffset;
+			h->nr_hashes++;
+		}
+	}
+}
+
+/* Feed the part of [off, end) that each hash covers */
+static void hlos_fit_hash(struct hlos_fit *h, ulong off, ulong end)
+{
+	struct hlos_hash *hh;
+	ulong from, to;
+	int i;
+
+	for (i = 0; i < h->nr_hashes; i++) {
+		hh = &h->hashes[i];
+		from = max(off, hh->off);
+		to = min(end, hh->off + hh->len);
+		if (from >= to)
+			continue;
+		hh->algo->hash_update(hh->algo, hh->ctx, h->dst + from,
+				      to - from, to == hh->off + hh->len);
+	}
+}
+
+static void hlos_fit_finish_hashes(struct hlos_fit *h, int ok)
+{
+	uint8_t value[FIT_MAX_HASH_LEN];
+	uint8_t *fit_value;
+	int fit_value_len;
+	struct hlos_hash *hh;
+	int i;
+
+	for (i = 0; i < h->nr_hashes; i++) {
+		hh = &h->hashes[i];
+		if (hh->algo->hash_finish(hh->algo, hh->ctx, value,
+					  sizeof(value)) || !ok)
+			continue;
+		/* calculate_hash() stores crc32 big endian */
+		if (!strcmp(hh->algo->name, "crc32"))
+			*(uint32_t *)value = cpu_to_uimage(*(uint32_t *)value);
+		if (fit_image_hash_get_value(h->dst, hh->noffset, &fit_value,
+					     &fit_value_len))
+			continue;
+		if (fit_value_len == hh->algo->digest_size &&
+		    !memcmp(value, fit_value, fit_value_len))
+			fit_image_hash_set_verified(h->dst, hh->noffset,
+						    value, fit_value_len);
+	}
+}
+
+/*
+ * Read the extents recorded by hlos_fit_read_meta(), keeping one read in
+ * flight while the previous chunk is hashed.
+ */
+static int hlos_fit_read_data(struct hlos_fit *h)
+{
+	struct hlos_src *src = h->src;
+	struct hlos_extent *ext;
+	ulong chunk = hlos_chunk(src);
+	ulong off, end, next, n, next_n, ext_off;
+	int i;
+
+	for (i = 0; i < h->nr_extents; i++) {
+		ext = &h->extents[i];
+		ext_off = h->base + ext->off;
+		off = rounddown(ext_off, src->align);
+		end = min(roundup(ext_off + ext->len, src->align), src->size);
+		n = min(end - off, chunk);
+		if (src->read_start(src, off, n, h->load + off))
+			return -EIO;
+
+		for (;;) {
+			if (src->read_finish(src))
+				return -EIO;
+
+			next = off + n;
+			next_n = min(end - next, chunk);
+			if (next_n &&
+			    src->read_start(src, next, next_n, h->load + next))
+				return -EIO;
+
+			/* Alignment padding may belong to a neighbour */
+			hlos_fit_hash(h, max(off, ext_off) - h->base,
+				      min(off + n, ext_off + ext->len) - h->base);
+			if (!next_n)
+				break;
+			off = next;
+			n = next_n;
+		}
+	}
+	return 0;
+}
+
+/* Load a FIT found base bytes into the first window */
+static int hlos_load_fit(struct hlos_src *src, uint8_t *load, ulong base)
+{
+	uint8_t *fit = load + base;
+	struct hlos_fit *h;
+	int ret;
+
+	if (base + sizeof(struct fdt_header) > src->size ||
+	    fdt_magic(fit) != FDT_MAGIC ||
+	    fdt_totalsize(fit) > src->size - base ||
+	    fdt_off_dt_struct(fit) >= fdt_totalsize(fit) ||
+	    fdt_off_dt_strings(fit) > fdt_totalsize(fit))
+		return -EINVAL;
+
+	h = calloc(1, sizeof(*h));
+	if (!h)
+		return -ENOMEM;
+
+	h->src = src;
+	h->load = load;
+	h->base = base;
+	h->dst = fit;
+	h->size = fdt_totalsize(fit);
+	h->win_end = min_t(ulong, HLOS_META_WINDOW - base, h->size);
+
+	ret = hlos_fit_read_meta(h);
+	if (!ret) {
+		hlos_fit_start_hashes(h);
+		ret = hlos_fit_read_data(h);
+		hlos_fit_finish_hashes(h, !ret);
+	}
+
+	free(h->extents);
+	free(h);
+	return ret;
+}
+
+/* Length of the legacy image at hdr, 0 if there is none */
+static ulong hlos_legacy_size(const void *hdr)
+{
+	if (!image_check_magic(hdr) || !image_check_hcrc(hdr))
+		return 0;
+	return image_get_image_size(hdr);
+}
+
+int hlos_load(struct hlos_src *src, void *dst)
+{
+	ulong win = min_t(ulong, HLOS_META_WINDOW, src->size);
+	ulong len;
+	int ret;
+
+	fit_image_hash_clear_verified();
+
+	if (hlos_read(src, dst, 0, win))
+		return -EIO;
+
+	ret = hlos_load_fit(src, dst, 0);
+	if (ret == -EINVAL)
+		ret = hlos_load_fit(src, dst, sizeof(mbn_header_t));
+	if (ret != -EINVAL && ret != -ENOMEM)
+		return ret;
+	fit_image_hash_clear_verified();
+
+	len = hlos_legacy_size(dst);
+	if (!len) {
+		len = hlos_legacy_size(dst + sizeof(mbn_header_t));
+		if (len)
+			len += sizeof(mbn_header_t);
+	}
+
+	/* Anything else, an ELF for instance, is read whole */
+	if (!len || len > src->size)
+		len = src->size;
+	if (len <= win)
+		return 0;
+	return hlos_read(src, dst, win, len - win);
+}
+
+#ifdef CONFIG_QCA_MMC
+static int hlos_mmc_start(struct hlos_src *src, ulong off, ulong len,
+			  void *dst)
+{
+	return mmc_bread_start(src->dev, src->start + off / src->align,
+			       len / src->align, dst);
+}
+
+static int hlos_mmc_finish(struct hlos_src *src)
+{
+	return mmc_bread_finish(src->dev) ? 0 : -EIO;
+}
+
+int hlos_src_mmc(struct hlos_src *src, int dev_num, ulong start,
+		 ulong blkcnt, ulong blksz)
+{
+	struct mmc *mmc = find_mmc_device(dev_num);
+
+	if (!mmc || !blksz)
+		return -ENODEV;
+
+	memset(src, 0, sizeof(*src));
+	src->read_start = hlos_mmc_start;
+	src->read_finish = hlos_mmc_finish;
+	src->size = blkcnt * blksz;
+	src->align = blksz;
+	src->max_read = mmc->cfg->b_max * blksz;
+	src->dev = dev_num;
+	src->start = start;
+	return 0;
+}
+#endif
+
+/* SPI NOR and UBI reads are synchronous, the data is there once started */
+static int __maybe_unused hlos_sync_finish(struct hlos_src *src)
+{
+	return src->err ? -EIO : 0;
+}
+
+#ifdef CONFIG_SPI_FLASH
+static int hlos_nor_start(struct hlos_src *src, ulong off, ulong len,
+			  void *dst)
+{
+	src->err = spi_flash_read(src->flash, src->start + off, len, dst);
+	return 0;
+}
+
+int hlos_src_nor(struct hlos_src *src, ulong offset, ulong size)
+{
+	memset(src, 0, sizeof(*src));
+	src->flash = spi_flash_probe(CONFIG_SF_DEFAULT_BUS,
+				     CONFIG_SF_DEFAULT_CS,
+				     CONFIG_SF_DEFAULT_SPEED,
+				     CONFIG_SF_DEFAULT_MODE);
+	if (!src->flash)
+		return -ENODEV;
+
+	src->read_start = hlos_nor_start;
+	src->read_finish = hlos_sync_finish;
+	src->size = size;
+	src->align = ARCH_DMA_MINALIGN;
+	src->max_read = size;
+	src->start = offset;
+	return 0;
+}
+#endif
+
+#ifdef CONFIG_CMD_UBI
+static int hlos_ubi_start(struct hlos_src *src, ulong off, ulong len,
+			  void *dst)
+{
+	src->err = ubi_volume_read_at(src->volume, dst, off, len);
+	return 0;
+}
+
+/* The UBI partition holding the volume must already be attached */
+int hlos_src_ubi(struct hlos_src *src, char *volume)
+{
+	long long size = ubi_get_volume_size(volume);
+
+	if (size <= 0)
+		return -ENODEV;
+
+	memset(src, 0, sizeof(*src));
+	src->read_start = hlos_ubi_start;
+	src->read_finish = hlos_sync_finish;
+	src->size = size;
+	src->align = ARCH_DMA_MINALIGN;
+	src->max_read = size;
+	src->volume = volume;
+	return 0;
+}
+#endif
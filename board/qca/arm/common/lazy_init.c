@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2020 The Linux Foundation. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 and
+ * only version 2 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <fdtdec.h>
+#include <net.h>
+#include <pci.h>
+#include <asm/arch-qca-common/qca_common.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/*
+ * USB, PCIe and ethernet are not needed to boot the kernel from flash,
+ * so they are brought up the first time something uses them instead of
+ * unconditionally before autoboot. Anything that must be up early is
+ * listed in the "eager_init" env variable or, failing that, the
+ * "eager-init" property of the /config FDT node, e.g. "usb pci" or "all".
+ */
+
+#ifndef CONFIG_IPQ_EAGER_INIT
+#define CONFIG_IPQ_EAGER_INIT	""
+#endif
+
+static int lazy_init_usb(void)
+{
+	return ipq_board_usb_init();
+}
+
+#if defined(CONFIG_PCI) && !defined(CONFIG_DM_PCI)
+static int lazy_init_pci(void)
+{
+	pci_init();
+	return 0;
+}
+#endif
+
+#ifdef CONFIG_CMD_NET
+static int lazy_init_net(void)
+{
+	puts("\nNet:   ");
+	return eth_initialize() < 0 ? -1 : 0;
+}
+#endif
+
+/* Indexed by enum ipq_lazy_dev, in bring up order */
+static struct {
+	const char *name;
+	int (*init)(void);
+	int up;
+	int busy;
+} lazy_devs[IPQ_LAZY_MAX] = {
+	[IPQ_LAZY_USB] = { "usb", lazy_init_usb, 0 },
+#if defined(CONFIG_PCI) && !defined(CONFIG_DM_PCI)
+	[IPQ_LAZY_PCI] = { "pci", lazy_init_pci, 0 },
+#endif
+#ifdef CONFIG_CMD_NET
+	[IPQ_LAZY_NET] = { "net", lazy_init_net, 0 },
+#endif
+};
+
+int ipq_lazy_init(enum ipq_lazy_dev dev)
+{
+	int ret;
+
+	if (dev >= IPQ_LAZY_MAX || !lazy_devs[dev].init)
+		return -1;
+	if (lazy_devs[dev].up || lazy_devs[dev].busy)
+		return 0;
+
+	/* Init itself goes through the hooked accessors, don't recurse */
+	lazy_devs[dev].busy = 1;
+	ret = lazy_devs[dev].init();
+	lazy_devs[dev].busy = 0;
+	if (ret < 0) {
+		/* Left down, so the next user tries again */
+		printf("WARN: %s init failed\n", lazy_devs[dev].name);
+		return ret;
+	}
+
+	lazy_devs[dev].up = 1;
+	return 0;
+}
+
+int ipq_lazy_is_up(enum ipq_lazy_dev dev)
+{
+	return dev < IPQ_LAZY_MAX && lazy_devs[dev].up;
+}
+
+void ipq_lazy_mark_down(enum ipq_lazy_dev dev)
+{
+	if (dev < IPQ_LAZY_MAX)
+		lazy_devs[dev].up = 0;
+}
+
+void ipq_lazy_init_all(void)
+{
+	int i;
+
+	for (i = 0; i < IPQ_LAZY_MAX; i++)
+		ipq_lazy_init(i);
+}
+
+static const char *lazy_init_policy(void)
+{
+	const char *policy;
+
+	policy = getenv("eager_init");
+	if (policy)
+		return policy;
+
+	policy = fdtdec_get_config_string(gd->fdt_blob, "eager-init");
+	if (policy)
+		return policy;
+
+	return CONFIG_IPQ_EAGER_INIT;
+}
+
+static int lazy_init_listed(const char *policy, const char *name)
+{
+	const char *end;
+	int len;
+
+	while (*policy) {
+		policy += strspn(policy, " ,");
+		end = strpbrk(policy, " ,");
+		if (!end)
+			end = policy + strlen(policy);
+		len = end - policy;
+		if ((len == strlen(name) && !strncmp(policy, name, len)) ||
+		    (len == 3 && !strncmp(policy, "all", 3)))
+			return 1;
+		policy = end;
+	}
+	return 0;
+}
+
+void ipq_lazy_init_eager(void)
+{
+	const char *policy = lazy_init_policy();
+	int i;
+
+	for (i = 0; i < IPQ_LAZY_MAX; i++) {
+		if (lazy_devs[i].name &&
+		    lazy_init_listed(policy, lazy_devs[i].name))
+			ipq_lazy_init(i);
+	}
+}
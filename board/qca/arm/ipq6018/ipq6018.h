@@ -246,7 +246,7 @@
 #ifdef CONFIG_SMEM_VERSION_C
 #define RAM_PART_NAME_LENGTH 16
 
-#define SECONDARY_CORE_STACKSZ (8 * 1024)
+#define SECONDARY_CORE_STACKSZ (32 * 1024)
 #define CPU_POWER_DOWN (1 << 16)
 
 #define ARM_PSCI_TZ_FN_BASE		0x84000000
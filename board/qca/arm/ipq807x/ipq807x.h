@@ -223,7 +223,7 @@
 #define USB3_PCS_TXDEEMPH_M6DB_V0		0x824
 #define USB3_PCS_TXDEEMPH_M3P5DB_V0		0x828
 
-#define SECONDARY_CORE_STACKSZ (8 * 1024)
+#define SECONDARY_CORE_STACKSZ (32 * 1024)
 #define CPU_POWER_DOWN (1 << 16)
 
 #define ARM_PSCI_TZ_FN_BASE		0x84000000
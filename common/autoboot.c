@@ -411,7 +411,11 @@ void autoboot_command(const char *s)
 	if (apps_iscrashed_crashdump_disabled()) {
 		printf("Crashdump disabled, resetting the board..\n");
 #ifdef CONFIG_LWIP_HTTPD
+#ifdef CONFIG_IPQ_LAZY_INIT
+		ipq_lazy_init(IPQ_LAZY_NET);
+#else
 		eth_initialize();
+#endif
 		run_command("httpd", 0);
 		return;
 #else
@@ -433,7 +437,11 @@ void autoboot_command(const char *s)
 #ifdef CONFIG_LWIP_HTTPD
 	else if (stored_bootdelay != -1) {
 #ifndef CONFIG_IPQ40XX
+#ifdef CONFIG_IPQ_LAZY_INIT
+		ipq_lazy_init(IPQ_LAZY_NET);
+#else
 		eth_initialize();
+#endif
 #endif
 		run_command("httpd", 0);
 		return;
@@ -448,6 +456,10 @@ void autoboot_command(const char *s)
 	}
 #endif /* CONFIG_MENUKEY */
 
+#if defined(CONFIG_IPQ_LAZY_INIT)
+	/* Back at the prompt, have everything up as before */
+	ipq_lazy_init_all();
+#else
 #ifdef CONFIG_IPQ_ETH_INIT_DEFER
 	puts("\nNet:   ");
 	eth_initialize();
@@ -455,4 +467,5 @@ void autoboot_command(const char *s)
 #ifdef CONFIG_IPQ_PCI_INIT_DEFER
 	pci_init();
 #endif
+#endif
 }
\ No newline at end of file
@@ -466,6 +466,20 @@ static int reserve_lcd(void)
 static int reserve_trace(void)
 {
 #ifdef CONFIG_TRACE
+#ifdef CONFIG_SYS_MEM_TOP_HIDE
+	/*
+	 * Without relocation the area below ram_top is not reserved for
+	 * anything, so use the window hidden above it instead. The board
+	 * sizes CONFIG_SYS_MEM_TOP_HIDE to hold the buffer.
+	 */
+	if (gd->flags & GD_FLG_SKIP_RELOC) {
+		gd->trace_buff = map_sysmem(gd->ram_top,
+					    CONFIG_TRACE_BUFFER_SIZE);
+		debug("Using %dk hidden at %08lx for trace data\n",
+		      CONFIG_TRACE_BUFFER_SIZE >> 10, (ulong)gd->ram_top);
+		return 0;
+	}
+#endif
 	gd->relocaddr -= CONFIG_TRACE_BUFFER_SIZE;
 	gd->trace_buff = map_sysmem(gd->relocaddr, CONFIG_TRACE_BUFFER_SIZE);
 	debug("Reserving %dk for trace data at: %08lx\n",
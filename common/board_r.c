@@ -262,7 +262,8 @@ static int initr_unlock_ram_in_cache(void)
 #ifdef CONFIG_PCI
 static int initr_pci(void)
 {
-#if !defined(CONFIG_DM_PCI) && !defined(CONFIG_IPQ_PCI_INIT_DEFER)
+#if !defined(CONFIG_DM_PCI) && !defined(CONFIG_IPQ_PCI_INIT_DEFER) && \
+	!defined(CONFIG_IPQ_LAZY_INIT)
 	pci_init();
 #endif
 
@@ -651,7 +652,7 @@ static int initr_bbmii(void)
 #ifdef CONFIG_CMD_NET
 static int initr_net(void)
 {
-#if !defined(CONFIG_IPQ_ETH_INIT_DEFER)
+#if !defined(CONFIG_IPQ_ETH_INIT_DEFER) && !defined(CONFIG_IPQ_LAZY_INIT)
 	puts("Net:   ");
 	eth_initialize();
 #endif
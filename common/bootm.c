@@ -22,6 +22,9 @@
 #if defined(CONFIG_CMD_USB)
 #include <usb.h>
 #endif
+#ifdef CONFIG_IPQ_LAZY_INIT
+#include <asm/arch-qca-common/qca_common.h>
+#endif
 #else
 #include "mkimage.h"
 #endif
@@ -720,12 +723,29 @@ int do_bootm_states(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 
 	/* Now run the OS! We hope this doesn't return */
 	if (!ret && (states & BOOTM_STATE_OS_GO)) {
+#ifdef CONFIG_IPQ_LAZY_INIT
+		/* Only tear down what was brought up on the way here */
+		if (ipq_lazy_is_up(IPQ_LAZY_PCI)) {
+			board_pci_deinit();
+			ipq_lazy_mark_down(IPQ_LAZY_PCI);
+		}
+#else
 		board_pci_deinit();
+#endif
 
 #ifdef CONFIG_USB_XHCI_IPQ
+#ifdef CONFIG_IPQ_LAZY_INIT
+		if (ipq_lazy_is_up(IPQ_LAZY_USB)) {
+			usb_stop();
+			for (i = 0; i < CONFIG_USB_MAX_CONTROLLER_COUNT; i++)
+				board_usb_deinit(i);
+			ipq_lazy_mark_down(IPQ_LAZY_USB);
+		}
+#else
 		usb_stop();
 		for (i = 0; i < CONFIG_USB_MAX_CONTROLLER_COUNT; i++)
 			board_usb_deinit(i);
+#endif
 #endif
 		/*
 		 * Edma cleanup
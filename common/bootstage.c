@@ -16,6 +16,7 @@
 #include <libfdt.h>
 #include <malloc.h>
 #include <linux/compiler.h>
+#include <asm/errno.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -212,6 +213,11 @@ static int add_bootstages_devicetree(struct fdt_header *blob)
 	if (!blob)
 		return 0;
 
+	/* Replace the node left by an earlier call with a fuller one */
+	bootstage = fdt_subnode_offset(blob, 0, "bootstage");
+	if (bootstage >= 0 && fdt_del_node(blob, bootstage))
+		return -1;
+
 	/*
 	 * Create the node for bootstage.
 	 * The address of flat device tree is set up by the command bootm.
@@ -257,11 +263,85 @@ int bootstage_fdt_add_report(void)
 
 	return 0;
 }
+
+int bootstage_fdt_add(void *blob)
+{
+	return add_bootstages_devicetree(blob);
+}
 #endif
 
+/**
+ * Get a copy of the records sorted by increasing time
+ *
+ * The table itself has to stay indexed by id, since later marks are
+ * recorded into it.
+ *
+ * @return sorted copy, to be freed by the caller, or NULL if out of memory
+ */
+static struct bootstage_record *get_sorted_records(void)
+{
+	struct bootstage_record *sorted;
+
+	sorted = malloc(sizeof(record));
+	if (!sorted)
+		return NULL;
+	memcpy(sorted, record, sizeof(record));
+	qsort(sorted, ARRAY_SIZE(record), sizeof(*sorted), h_compare_record);
+
+	return sorted;
+}
+
+int bootstage_json(char *buf, int size)
+{
+	struct bootstage_record *sorted, *rec;
+	uint32_t prev = 0;
+	char name[20];
+	int pos = 0;
+	int first;
+	int id;
+
+#define JSON_OUT(...) \
+	(pos += snprintf(buf + pos, pos < size ? size - pos : 0, __VA_ARGS__))
+
+	sorted = get_sorted_records();
+	if (!sorted)
+		return -ENOMEM;
+
+	JSON_OUT("{\"unit\":\"us\",\"stages\":[");
+	JSON_OUT("{\"name\":\"reset\",\"mark\":0,\"elapsed\":0}");
+	for (id = 0, rec = sorted; id < BOOTSTAGE_ID_COUNT; id++, rec++) {
+		if (!rec->time_us || rec->start_us)
+			continue;
+		JSON_OUT(",{\"id\":%d,\"name\":\"%s\",\"mark\":%lu,"
+			 "\"elapsed\":%u}", rec->id,
+			 get_record_name(name, sizeof(name), rec),
+			 rec->time_us, (uint32_t)rec->time_us - prev);
+		prev = rec->time_us;
+	}
+
+	JSON_OUT("],\"accum\":[");
+	for (id = 0, first = 1, rec = record; id < BOOTSTAGE_ID_COUNT;
+	     id++, rec++) {
+		if (!rec->start_us)
+			continue;
+		JSON_OUT("%s{\"id\":%d,\"name\":\"%s\",\"time\":%lu}",
+			 first ? "" : ",", id,
+			 get_record_name(name, sizeof(name), rec),
+			 rec->time_us);
+		first = 0;
+	}
+	JSON_OUT("]}");
+#undef JSON_OUT
+
+	free(sorted);
+
+	return pos;
+}
+
 void bootstage_report(void)
 {
 	struct bootstage_record *rec = record;
+	struct bootstage_record *sorted;
 	int id;
 	uint32_t prev;
 
@@ -274,12 +354,18 @@ void bootstage_report(void)
 	prev = print_time_record(BOOTSTAGE_ID_AWAKE, rec, 0);
 
 	/* Sort records by increasing time */
-	qsort(record, ARRAY_SIZE(record), sizeof(*rec), h_compare_record);
+	sorted = get_sorted_records();
+	if (sorted)
+		rec = sorted;
+	else
+		qsort(record, ARRAY_SIZE(record), sizeof(*rec),
+		      h_compare_record);
 
 	for (id = 0; id < BOOTSTAGE_ID_COUNT; id++, rec++) {
 		if (rec->time_us != 0 && !rec->start_us)
 			prev = print_time_record(rec->id, rec, prev);
 	}
+	free(sorted);
 	if (next_id > BOOTSTAGE_ID_COUNT)
 		printf("(Overflowed internal boot id table by %d entries\n"
 			"- please increase CONFIG_BOOTSTAGE_USER_COUNT\n",
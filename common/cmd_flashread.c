@@ -455,9 +455,33 @@ static int nand_raw_chunk_read(uint32_t load_addr, u64 user_offset,
 #endif
 
 #ifdef CONFIG_QCA_MMC
-static u64 emmc_cached_base_offset = 0;
-static u64 emmc_cached_part_size = 0;
-static char emmc_cached_part_name[32] = "";
+/*
+ * Read in b_max sized pieces through the split-phase MMC API and service
+ * the network while each piece is being transferred by the host DMA.
+ */
+static ulong emmc_read_yield(int dev, lbaint_t start, lbaint_t blkcnt, void *dst)
+{
+	struct mmc *mmc = find_mmc_device(dev);
+	lbaint_t done = 0, cur;
+
+	if (!mmc)
+		return 0;
+
+	while (done < blkcnt) {
+		cur = min(blkcnt - done, (lbaint_t)mmc->cfg->b_max);
+		if (mmc_bread_start(dev, start + done, cur,
+				dst + done * mmc->read_bl_len))
+			break;
+		while (mmc_bread_poll(dev) == -EBUSY)
+			if (flashread_yield_fn)
+				flashread_yield_fn();
+		if (mmc_bread_finish(dev) != cur)
+			break;
+		done += cur;
+	}
+
+	return done;
+}
 
 static int emmc_chunk_read(const char *part_name, uint32_t load_addr,
 			u64 user_offset, uint32_t user_size,
@@ -467,30 +491,17 @@ static int emmc_chunk_read(const char *part_name, uint32_t load_addr,
 	block_dev_desc_t *blk_dev = mmc_get_dev(mmc_host.dev_num);
 	u64 base_offset = 0, part_total_size = 0, chunk_offset, remain;
 	uint32_t blksz, start_sector, num_sectors, chunk;
+	disk_partition_t disk_info;
 
 	if (!blk_dev)
 		return CMD_RET_FAILURE;
-	if (strcmp(part_name, emmc_cached_part_name) == 0 && emmc_cached_part_size > 0) {
-		base_offset = emmc_cached_base_offset;
-		part_total_size = emmc_cached_part_size;
-	} else {
-		disk_partition_t disk_info;
-		int gpt_count, i;
-		gpt_count = get_partition_count_efi(blk_dev);
-		for (i = 1; i <= gpt_count; i++) {
-			if (get_partition_info_efi(blk_dev, i, &disk_info) == 0 &&
-				strcmp((const char *)disk_info.name, part_name) == 0) {
-				base_offset = (u64)disk_info.start * (u64)blk_dev->blksz;
-				part_total_size = (u64)disk_info.size * (u64)blk_dev->blksz;
-				break;
-			}
-		}
-		if (part_total_size == 0)
-			return CMD_RET_FAILURE;
-		emmc_cached_base_offset = base_offset;
-		emmc_cached_part_size = part_total_size;
-		strncpy(emmc_cached_part_name, part_name, sizeof(emmc_cached_part_name) - 1);
+	/* Served from the cached GPT, cheap to repeat for every chunk */
+	if (get_partition_info_efi_by_name(blk_dev, part_name, &disk_info) == 0) {
+		base_offset = (u64)disk_info.start * (u64)blk_dev->blksz;
+		part_total_size = (u64)disk_info.size * (u64)blk_dev->blksz;
 	}
+	if (part_total_size == 0)
+		return CMD_RET_FAILURE;
 	if (user_offset >= part_total_size) {
 		if (out_offset) *out_offset = (uint32_t)user_offset;
 		if (out_size) *out_size = 0;
@@ -504,7 +515,7 @@ static int emmc_chunk_read(const char *part_name, uint32_t load_addr,
 	num_sectors = (chunk + blksz - 1) / blksz;
 	printf("MMC read: dev # %d, block # %u, count %u ...\n",
 		mmc_host.dev_num, start_sector, num_sectors);
-	if (blk_dev->block_read(mmc_host.dev_num, start_sector, num_sectors, (void *)load_addr) != num_sectors) {
+	if (emmc_read_yield(mmc_host.dev_num, start_sector, num_sectors, (void *)load_addr) != num_sectors) {
 		printf("MMC read failed\n");
 		return CMD_RET_FAILURE;
 	}
@@ -101,10 +101,21 @@ uint32_t part_size, uint32_t file_size, char *layout)
 
 	} else if (flash_type == SMEM_BOOT_MMC_FLASH) {
 
-		snprintf(runcmd, sizeof(runcmd),
-			"mmc erase 0x%x 0x%x && "
+		/*
+		 * The write replaces everything it covers, so only the
+		 * tail the image does not reach needs clearing. That is
+		 * done first: without TRIM support it becomes an erase of
+		 * whole erase groups, which may reach back into the image.
+		 */
+		runcmd[0] = '\0';
+		if (part_size > file_size)
+			snprintf(runcmd, sizeof(runcmd),
+				"mmc trim 0x%x 0x%x && ",
+				offset + file_size, part_size - file_size);
+
+		snprintf(runcmd + strlen(runcmd),
+			sizeof(runcmd) - strlen(runcmd),
 			"mmc write 0x%x 0x%x 0x%x && ",
-			offset, part_size,
 			address, offset, file_size);
 
 	} else if (flash_type == SMEM_BOOT_SPI_FLASH) {
@@ -304,7 +315,7 @@ static int fl_erase(int flash_type, uint32_t offset, uint32_t part_size,
 	} else if (flash_type == SMEM_BOOT_MMC_FLASH) {
 
 		snprintf(runcmd, sizeof(runcmd),
-				"mmc erase 0x%x 0x%x ",
+				"mmc trim 0x%x 0x%x ",
 				 offset, part_size);
 
 	} else if (flash_type == SMEM_BOOT_SPI_FLASH) {
@@ -22,6 +22,7 @@
 #endif
 #include <hash.h>
 #include <inttypes.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <watchdog.h>
 #include <asm/io.h>
@@ -1358,6 +1359,86 @@ static int do_mem_info(cmd_tbl_t *cmdtp, int flag, int argc,
 }
 #endif
 
+#ifdef CONFIG_CMD_MEMBENCH
+static void mem_bench_report(const char *what, ulong bytes, ulong us)
+{
+	/* bytes per microsecond is MB/s */
+	printf("%-24s %8lu us %6lu MB/s\n", what, us, bytes / (us ? us : 1));
+}
+
+/*
+ * Measure memcpy(), memmove() and memset() throughput. Besides the
+ * aligned case, copy with the source 2 bytes off (network payloads
+ * behind a 14 byte Ethernet header) and with both pointers misaligned
+ * differently.
+ */
+static int do_mem_bench(cmd_tbl_t *cmdtp, int flag, int argc,
+			char * const argv[])
+{
+	static const struct {
+		const char *name;
+		int dst_off;
+		int src_off;
+	} cpy[] = {
+		{ "memcpy aligned", 0, 0 },
+		{ "memcpy src+2", 0, 2 },
+		{ "memcpy dst+1 src+3", 1, 3 },
+	};
+	ulong size = 0x10000, loops = 0, i, t;
+	char *src, *dst;
+	int c;
+
+	if (argc > 1)
+		size = simple_strtoul(argv[1], NULL, 16);
+	if (argc > 2)
+		loops = simple_strtoul(argv[2], NULL, 10);
+	if (size == 0)
+		return CMD_RET_USAGE;
+	if (loops == 0)
+		loops = max((ulong)(64 << 20) / size, 1UL);
+
+	src = malloc(size + 8);
+	dst = malloc(size + 8);
+	if (!src || !dst) {
+		printf("Can't allocate 2 x %lu bytes\n", size + 8);
+		free(src);
+		free(dst);
+		return CMD_RET_FAILURE;
+	}
+	memset(src, 0x5a, size + 8);
+	memset(dst, 0xa5, size + 8);
+
+	printf("%lu bytes x %lu\n", size, loops);
+
+	for (c = 0; c < ARRAY_SIZE(cpy); c++) {
+		t = timer_get_us();
+		for (i = 0; i < loops; i++)
+			memcpy(dst + cpy[c].dst_off, src + cpy[c].src_off, size);
+		mem_bench_report(cpy[c].name, size * loops,
+				 timer_get_us() - t);
+		if (ctrlc())
+			goto out;
+	}
+
+	t = timer_get_us();
+	for (i = 0; i < loops; i++)
+		memmove(src + 1, src, size);
+	mem_bench_report("memmove overlap dst+1", size * loops,
+			 timer_get_us() - t);
+
+	t = timer_get_us();
+	for (i = 0; i < loops; i++)
+		memset(dst + 1, i, size);
+	mem_bench_report("memset dst+1", size * loops, timer_get_us() - t);
+
+out:
+	free(src);
+	free(dst);
+
+	return CMD_RET_SUCCESS;
+}
+#endif
+
 U_BOOT_CMD(
 	loop,	3,	1,	do_mem_loop,
 	"infinite loop on address range",
@@ -1410,6 +1491,15 @@ U_BOOT_CMD(
 );
 #endif /* CONFIG_MX_CYCLIC */
 
+#ifdef CONFIG_CMD_MEMBENCH
+U_BOOT_CMD(
+	membench,	3,	1,	do_mem_bench,
+	"measure memcpy/memmove/memset throughput",
+	"[size [loops]]\n"
+	"    - copy/fill 'size' (hex, default 0x10000) bytes 'loops' times"
+);
+#endif
+
 #ifdef CONFIG_CMD_MEMINFO
 U_BOOT_CMD(
 	meminfo,	3,	1,	do_mem_info,
@@ -710,15 +710,23 @@ ulong getenv_ulong(const char *name, int base, ulong default_val)
 static int do_env_save(cmd_tbl_t *cmdtp, int flag, int argc,
 		       char * const argv[])
 {
+	if (argc > 1) {
+		if (strcmp(argv[1], "-f"))
+			return CMD_RET_USAGE;
+		/* Rewrite even if nothing changed, e.g. after a flash erase */
+		env_htab.dirty = 1;
+	}
+
 	printf("Saving Environment to %s...\n", env_name_spec);
 
 	return saveenv() ? 1 : 0;
 }
 
 U_BOOT_CMD(
-	saveenv, 1, 0,	do_env_save,
+	saveenv, 2, 0,	do_env_save,
 	"save environment variables to persistent storage",
-	""
+	"[-f]\n"
+	"    - only writes if the environment changed, unless -f is given"
 );
 #endif
 #endif /* CONFIG_SPL_BUILD */
@@ -1120,6 +1128,92 @@ static int do_env_exists(cmd_tbl_t *cmdtp, int flag, int argc,
 }
 #endif
 
+#if defined(CONFIG_CMD_ENV_BENCH)
+/* Debug aid, keep it out of production configs */
+#define ENV_BENCH_MAX		65536
+/* ".bench" plus the digits of ULONG_MAX and the terminator */
+#define ENV_BENCH_NAME_LEN	(sizeof(".bench") + 20)
+
+static void env_bench_report(const char *what, unsigned long us,
+			     unsigned long count)
+{
+	printf("%-16s %8lu us  %6lu ns/op\n", what, us, us * 1000 / count);
+}
+
+/*
+ * Time setenv()/getenv() on a batch of hidden ".benchN" variables
+ * which are removed again afterwards.
+ */
+static int do_env_bench(cmd_tbl_t *cmdtp, int flag, int argc,
+			char * const argv[])
+{
+	char (*names)[ENV_BENCH_NAME_LEN];
+	unsigned long count = 256, i, t;
+	int dirty = env_htab.dirty;
+	int ret = CMD_RET_SUCCESS;
+
+	if (argc > 1)
+		count = simple_strtoul(argv[1], NULL, 10);
+	if (count == 0 || count > ENV_BENCH_MAX)
+		return CMD_RET_USAGE;
+
+	names = malloc(count * sizeof(*names));
+	if (!names) {
+		printf("## Can't malloc %lu bytes\n", count * sizeof(*names));
+		return CMD_RET_FAILURE;
+	}
+	for (i = 0; i < count; i++)
+		sprintf(names[i], ".bench%lu", i);
+
+	printf("%u variables in %u slots, adding %lu\n",
+	       env_htab.filled, env_htab.size, count);
+
+	t = timer_get_us();
+	for (i = 0; i < count; i++) {
+		if (setenv(names[i], "0")) {
+			printf("## Only %lu variables could be added\n", i);
+			count = i;
+			ret = CMD_RET_FAILURE;
+			break;
+		}
+	}
+	if (count == 0)
+		goto out;
+	env_bench_report("setenv (new)", timer_get_us() - t, count);
+
+	t = timer_get_us();
+	for (i = 0; i < count; i++)
+		setenv(names[i], "1");
+	env_bench_report("setenv (update)", timer_get_us() - t, count);
+
+	t = timer_get_us();
+	for (i = 0; i < count; i++)
+		getenv(names[i]);
+	env_bench_report("getenv (hit)", timer_get_us() - t, count);
+
+	for (i = 0; i < count; i++)
+		names[i][1] = 'B';
+	t = timer_get_us();
+	for (i = 0; i < count; i++)
+		getenv(names[i]);
+	env_bench_report("getenv (miss)", timer_get_us() - t, count);
+
+	for (i = 0; i < count; i++)
+		names[i][1] = 'b';
+	t = timer_get_us();
+	for (i = 0; i < count; i++)
+		setenv(names[i], NULL);
+	env_bench_report("setenv (delete)", timer_get_us() - t, count);
+
+out:
+	free(names);
+	/* the variables are gone again, nothing to save */
+	env_htab.dirty = dirty;
+
+	return ret;
+}
+#endif
+
 /*
  * New command line interface: "env" command with subcommands
  */
@@ -1132,6 +1226,9 @@ static cmd_tbl_t cmd_env_sub[] = {
 #if defined(CONFIG_CMD_EDITENV)
 	U_BOOT_CMD_MKENT(edit, 2, 0, do_env_edit, "", ""),
 #endif
+#if defined(CONFIG_CMD_ENV_BENCH)
+	U_BOOT_CMD_MKENT(bench, 2, 0, do_env_bench, "", ""),
+#endif
 #if defined(CONFIG_CMD_ENV_CALLBACK)
 	U_BOOT_CMD_MKENT(callbacks, 1, 0, do_env_callback, "", ""),
 #endif
@@ -1152,7 +1249,7 @@ static cmd_tbl_t cmd_env_sub[] = {
 	U_BOOT_CMD_MKENT(run, CONFIG_SYS_MAXARGS, 1, do_run, "", ""),
 #endif
 #if defined(CONFIG_CMD_SAVEENV) && !defined(CONFIG_ENV_IS_NOWHERE)
-	U_BOOT_CMD_MKENT(save, 1, 0, do_env_save, "", ""),
+	U_BOOT_CMD_MKENT(save, 2, 0, do_env_save, "", ""),
 #endif
 	U_BOOT_CMD_MKENT(set, CONFIG_SYS_MAXARGS, 0, do_env_set, "", ""),
 #if defined(CONFIG_CMD_ENV_EXISTS)
@@ -1191,6 +1288,9 @@ static char env_help_text[] =
 #if defined(CONFIG_CMD_ASKENV)
 	"ask name [message] [size] - ask for environment variable\nenv "
 #endif
+#if defined(CONFIG_CMD_ENV_BENCH)
+	"bench [count] - time getenv/setenv on count (max 65536) scratch variables\nenv "
+#endif
 #if defined(CONFIG_CMD_ENV_CALLBACK)
 	"callbacks - print callbacks and their associated variables\nenv "
 #endif
@@ -1224,7 +1324,7 @@ static char env_help_text[] =
 	"env run var [...] - run commands in an environment variable\n"
 #endif
 #if defined(CONFIG_CMD_SAVEENV) && !defined(CONFIG_ENV_IS_NOWHERE)
-	"env save - save environment\n"
+	"env save [-f] - save environment, -f even if unchanged\n"
 #endif
 	"env set [-f] name [arg ...]\n";
 #endif
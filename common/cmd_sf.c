@@ -330,6 +330,24 @@ static int do_spi_flash_read_write(int argc, char * const argv[])
 			printf("OK\n");
 	}
 
+#ifndef CONFIG_DISABLE_CMD_SF_BENCH
+	if (strcmp(argv[0], "bench") == 0) {
+		ulong start, ms;
+
+		start = get_timer(0);
+		ret = spi_flash_read(flash, offset, len, buf);
+		ms = get_timer(start);
+
+		printf("SF: %zu bytes @ %#x read with cmd 0x%02x: ",
+		       (size_t)len, (u32)offset, flash->read_cmd);
+		if (ret)
+			printf("ERROR %d\n", ret);
+		else
+			printf("%lu ms, %llu KiB/s\n", ms,
+			       lldiv((u64)len * 1000, (ms ? ms : 1) * 1024));
+	}
+#endif
+
 	unmap_physmem(buf, len);
 
 	return ret == 0 ? 0 : 1;
@@ -608,6 +626,9 @@ static int do_spi_flash(cmd_tbl_t *cmdtp, int flag, int argc,
 	if (strcmp(cmd, "read") == 0 || strcmp(cmd, "write") == 0
 #ifndef CONFIG_DISABLE_CMD_SF_UPDATE
 	    || strcmp(cmd, "update") == 0
+#endif
+#ifndef CONFIG_DISABLE_CMD_SF_BENCH
+	    || strcmp(cmd, "bench") == 0
 #endif
 	   )
 		ret = do_spi_flash_read_write(argc, argv);
@@ -662,6 +683,10 @@ U_BOOT_CMD(
 	"					  at `addr' to flash at `offset'\n"
 	"					  or to start of mtd `partition'\n"
 #endif
+#ifndef CONFIG_DISABLE_CMD_SF_BENCH
+	"sf bench addr offset|partition len	- read `len' bytes to `addr' and\n"
+	"					  report the read throughput\n"
+#endif
 #ifndef CONFIG_DISABLE_CMD_SF_PROTECT
 	"sf protect lock/unlock sector len	- protect/unprotect 'len' bytes starting\n"
 	"					  at address 'sector'\n"
@@ -10,6 +10,9 @@
 #include <trace.h>
 #include <asm/io.h>
 
+/* Functions listed by 'trace stats' unless a count is given */
+#define TRACE_TOP_DEFAULT	10
+
 static int get_args(int argc, char * const argv[], char **buff,
 		    size_t *buff_ptr, size_t *buff_size)
 {
@@ -101,6 +104,8 @@ int do_trace(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 		break;
 	case 's':
 		trace_print_stats();
+		trace_print_top(argc > 2 ? simple_strtoul(argv[2], NULL, 10) :
+				TRACE_TOP_DEFAULT);
 		break;
 	default:
 		return CMD_RET_USAGE;
@@ -112,7 +117,8 @@ int do_trace(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 U_BOOT_CMD(
 	trace,	4,	1,	do_trace,
 	"trace utility commands",
-	"stats                        - display tracing statistics\n"
+	"stats [<count>]              - display tracing statistics and the\n"
+	"                                     <count> functions taking most time\n"
 	"trace pause                        - pause tracing\n"
 	"trace resume                       - resume tracing\n"
 	"trace funclist [<addr> <size>]     - dump function list into buffer\n"
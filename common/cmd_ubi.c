@@ -264,6 +264,26 @@ out_err:
 	return err;
 }
 
+static int ubi_volume_update_done(struct ubi_volume *vol)
+{
+	int err;
+
+	err = ubi_check_volume(ubi, vol->vol_id);
+	if (err < 0)
+		return -err;
+
+	if (err) {
+		ubi_warn(ubi, "volume %d on UBI device %d is corrupt",
+			 vol->vol_id, ubi->ubi_num);
+		vol->corrupted = 1;
+	}
+
+	vol->checked = 1;
+	ubi_gluebi_updated(vol);
+
+	return 0;
+}
+
 static int ubi_volume_continue_write(char *volume, void *buf, size_t size)
 {
 	int err = 1;
@@ -279,22 +299,8 @@ static int ubi_volume_continue_write(char *volume, void *buf, size_t size)
 		return -err;
 	}
 
-	if (err) {
-		size = err;
-
-		err = ubi_check_volume(ubi, vol->vol_id);
-		if (err < 0)
-			return -err;
-
-		if (err) {
-			ubi_warn(ubi, "volume %d on UBI device %d is corrupt",
-				 vol->vol_id, ubi->ubi_num);
-			vol->corrupted = 1;
-		}
-
-		vol->checked = 1;
-		ubi_gluebi_updated(vol);
-	}
+	if (err)
+		return ubi_volume_update_done(vol);
 
 	return 0;
 }
@@ -330,6 +336,148 @@ int ubi_volume_write(char *volume, void *buf, size_t size)
 	return ubi_volume_begin_write(volume, buf, size, size);
 }
 
+/*
+ * Make sure a dynamic volume of exactly the size needed for @size bytes
+ * exists. A volume which already has the right number of LEBs is kept as
+ * it is, as it is going to be wiped by the update anyway. A @size of zero
+ * means all the available space.
+ */
+int ubi_volume_prepare(char *volume, size_t size)
+{
+	struct ubi_volume *vol = NULL;
+	int i, err, pebs;
+	int64_t bytes = size;
+
+	if (!ubi_dev.selected) {
+		printf("Error, no UBI device/partition selected!\n");
+		return 1;
+	}
+
+	for (i = 0; i < ubi->vtbl_slots; i++) {
+		if (ubi->volumes[i] && !strcmp(ubi->volumes[i]->name, volume)) {
+			vol = ubi->volumes[i];
+			break;
+		}
+	}
+
+	if (vol && bytes && vol->vol_type == UBI_DYNAMIC_VOLUME) {
+		pebs = div_u64(bytes + vol->usable_leb_size - 1,
+			       vol->usable_leb_size);
+		if (pebs == vol->reserved_pebs) {
+			printf("Reusing UBI volume %s (id %d)\n", vol->name,
+			       vol->vol_id);
+			return 0;
+		}
+	}
+
+	if (vol) {
+		err = ubi_remove_vol(volume);
+		if (err)
+			return err;
+	}
+
+	if (!bytes)
+		bytes = (int64_t)ubi->avail_pebs * ubi->leb_size;
+
+	return ubi_create_vol(volume, bytes, 1);
+}
+
+int ubi_volume_remove(char *volume)
+{
+	if (!ubi_dev.selected) {
+		printf("Error, no UBI device/partition selected!\n");
+		return 1;
+	}
+
+	return ubi_remove_vol(volume);
+}
+
+static int ubi_volume_start_multi(struct ubi_volume *vol, size_t size)
+{
+	int err, rsvd_bytes;
+
+	rsvd_bytes = vol->reserved_pebs * (ubi->leb_size - vol->data_pad);
+	if (size > rsvd_bytes) {
+		printf("size > volume %s size! Aborting!\n", vol->name);
+		return EINVAL;
+	}
+
+	err = ubi_start_update(ubi, vol, size);
+	if (err < 0) {
+		printf("Cannot start volume %s update\n", vol->name);
+		return -err;
+	}
+	return 0;
+}
+
+/*
+ * Write the same @size bytes from @buf to each of the @count volumes
+ * (e.g. a primary and a backup bank) in a single pass over the source data:
+ * every LEB worth of input is handed to all the volumes while it is still
+ * hot in the cache, instead of streaming the whole image once per volume.
+ *
+ * Only volumes[0] has to succeed, the others are best effort: a failure
+ * on one of them is reported and that volume is dropped from the pass.
+ */
+int ubi_volume_write_multi(char * const volumes[], int count,
+			   const void *buf, size_t size)
+{
+	struct ubi_volume *vol[UBI_MAX_VOLUMES];
+	size_t offs, len;
+	int i, err;
+
+	if (!ubi_dev.selected) {
+		printf("Error, no UBI device/partition selected!\n");
+		return 1;
+	}
+
+	if (count <= 0 || count > UBI_MAX_VOLUMES)
+		return EINVAL;
+
+	for (i = 0; i < count; i++) {
+		vol[i] = ubi_find_volume(volumes[i]);
+		err = vol[i] ? ubi_volume_start_multi(vol[i], size) : ENODEV;
+		if (err) {
+			if (i == 0)
+				return err;
+			printf("Skipping volume %s\n", volumes[i]);
+			vol[i] = NULL;
+		}
+	}
+
+	if (!size)
+		return 0;
+
+	for (offs = 0; offs < size; offs += len) {
+		len = min_t(size_t, size - offs, ubi->leb_size);
+
+		for (i = 0; i < count; i++) {
+			if (!vol[i])
+				continue;
+
+			err = ubi_more_update_data(ubi, vol[i],
+						   (const char *)buf + offs,
+						   len);
+			if (err < 0) {
+				printf("Couldnt or partially wrote data to %s\n",
+				       volumes[i]);
+				err = -err;
+			} else if (err) {
+				err = ubi_volume_update_done(vol[i]);
+			}
+
+			if (err) {
+				if (i == 0)
+					return err;
+				printf("Skipping volume %s\n", volumes[i]);
+				vol[i] = NULL;
+			}
+		}
+	}
+
+	return 0;
+}
+
 long long ubi_get_volume_size(char *volume)
 {
 	struct ubi_volume *vol;
@@ -342,12 +490,16 @@ long long ubi_get_volume_size(char *volume)
 }
 
 int ubi_volume_read(char *volume, char *buf, size_t size)
+{
+	return ubi_volume_read_at(volume, buf, 0, size);
+}
+
+int ubi_volume_read_at(char *volume, char *buf, loff_t offp, size_t size)
 {
 	int err, lnum, off, len, tbuf_size;
 	void *tbuf;
 	unsigned long long tmp;
 	struct ubi_volume *vol;
-	loff_t offp = 0;
 
 	vol = ubi_find_volume(volume);
 	if (vol == NULL)
@@ -361,12 +513,12 @@ int ubi_volume_read(char *volume, char *buf, size_t size)
 		printf("damaged volume, update marker is set");
 		return EBADF;
 	}
-	if (offp == vol->used_bytes)
+	if (offp >= vol->used_bytes)
 		return 0;
 
 	if (size == 0) {
 		printf("No size specified -> Using max size (%lld)\n", vol->used_bytes);
-		size = vol->used_bytes;
+		size = vol->used_bytes - offp;
 	}
 
 	if (vol->corrupted)
@@ -446,11 +598,13 @@ static int ubi_dev_scan(struct mtd_info *info, char *ubidev,
 		return -err;
 	}
 
+	bootstage_mark_name(BOOTSTAGE_ID_UBI_ATTACH, "ubi_attach");
 	err = ubi_init();
 	if (err) {
 		del_mtd_partitions(info);
 		return -err;
 	}
+	bootstage_mark_name(BOOTSTAGE_ID_UBI_ATTACH_DONE, "ubi_attach_done");
 
 	ubi_initialized = 1;
 
@@ -224,6 +224,8 @@ int env_import(const char *buf, int check)
 	if (himport_r(&env_htab, (char *)ep->data, ENV_SIZE, '\0', 0, 0,
 			0, NULL)) {
 		gd->flags |= GD_FLG_ENV_READY;
+		/* What is in RAM now matches the stored copy */
+		env_htab.dirty = 0;
 		return 1;
 	}
 
@@ -234,6 +236,19 @@ int env_import(const char *buf, int check)
 	return 0;
 }
 
+/*
+ * Returns 0 if nothing changed since the environment was loaded or last
+ * saved, so the backends can skip rewriting the flash.
+ */
+int env_needs_save(void)
+{
+	if (env_htab.dirty)
+		return 1;
+
+	puts("Environment unchanged, not saved\n");
+	return 0;
+}
+
 /* Emport the environment and generate CRC for it. */
 int env_export(env_t *env_out)
 {
@@ -299,8 +314,6 @@ int env_complete(char *var, int maxv, char *cmdv[], int bufsz, char *buf)
 		bufsz -= vallen;
 	}
 
-	qsort(cmdv, found, sizeof(cmdv[0]), strcmp_compar);
-
 	if (idx)
 		cmdv[found++] = "...";
 
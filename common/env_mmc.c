@@ -143,8 +143,12 @@ int mmc_saveenv(void)
 	u32	offset;
 	int	ret, copy = 0;
 	const char *errmsg;
+	env_t *env_new;
 
-	env_t *env_new = (env_t *)memalign(ARCH_DMA_MINALIGN, CONFIG_ENV_SIZE);
+	if (!env_needs_save())
+		return 0;
+
+	env_new = (env_t *)memalign(ARCH_DMA_MINALIGN, CONFIG_ENV_SIZE);
 	if (!env_new) {
 		printf("Error: Cannot allocate %d bytes\n", CONFIG_ENV_SIZE);
 		return 1;
@@ -183,6 +187,7 @@ int mmc_saveenv(void)
 
 	puts("done\n");
 	ret = 0;
+	env_htab.dirty = 0;
 
 #ifdef CONFIG_ENV_OFFSET_REDUND
 	gd->env_valid = gd->env_valid == 2 ? 1 : 2;
@@ -203,7 +203,12 @@ int nand_saveenv(void)
 #endif
 	};
 
-	env_t *env_new = (env_t *)memalign(ARCH_DMA_MINALIGN, CONFIG_ENV_SIZE);
+	env_t *env_new;
+
+	if (!env_needs_save())
+		return 0;
+
+	env_new = (env_t *)memalign(ARCH_DMA_MINALIGN, CONFIG_ENV_SIZE);
 	if (!env_new) {
 		printf("Error: Cannot allocate %d bytes\n", CONFIG_ENV_SIZE);
 		return 1;
@@ -229,6 +234,7 @@ int nand_saveenv(void)
 	if (!ret) {
 		/* preset other copy for next write */
 		gd->env_valid = gd->env_valid == 2 ? 1 : 2;
+		env_htab.dirty = 0;
 		free(env_new);
 		return ret;
 	}
@@ -239,6 +245,8 @@ int nand_saveenv(void)
 		printf("Warning: primary env write failed,"
 				" redundancy is lost!\n");
 #endif
+	if (!ret)
+		env_htab.dirty = 0;
 	free(env_new);
 	return ret;
 }
@@ -52,6 +52,9 @@ int sf_saveenv(void)
 	u32	saved_size, saved_offset, sector = 1;
 	int	ret;
 
+	if (!env_needs_save())
+		return 0;
+
 	env_flash = spi_flash_probe(CONFIG_SF_DEFAULT_BUS,
 		CONFIG_SF_DEFAULT_CS,
 		CONFIG_SF_DEFAULT_SPEED, CONFIG_SF_DEFAULT_MODE);
@@ -122,6 +125,7 @@ int sf_saveenv(void)
 	puts("done\n");
 
 	gd->env_valid = gd->env_valid == 2 ? 1 : 2;
+	env_htab.dirty = 0;
 
 	printf("Valid environment: %d\n", (int)gd->env_valid);
 
@@ -217,6 +221,52 @@ out:
 	free(tmp_env2);
 }
 #else
+/*
+ * Erase and write only the erase blocks whose contents change. Most of
+ * the environment area is padding, so a save usually touches one or two
+ * blocks instead of the whole range. Returns 1 if the area cannot be
+ * handled per block.
+ */
+static int sf_env_write_changed(u32 offset, u32 size, const char *buf)
+{
+	u32	blk = env_flash->erase_size, off, written = 0;
+	char	*old;
+	int	ret = 0;
+
+	if (!blk || (offset % blk) || (size % blk))
+		return 1;
+
+	old = memalign(ARCH_DMA_MINALIGN, blk);
+	if (!old)
+		return 1;
+
+	puts("Writing changed blocks to SPI flash...");
+	for (off = 0; off < size; off += blk) {
+		ret = spi_flash_read(env_flash, offset + off, blk, old);
+		if (ret)
+			break;
+
+		if (!memcmp(old, buf + off, blk))
+			continue;
+
+		ret = spi_flash_erase(env_flash, offset + off, blk);
+		if (ret)
+			break;
+
+		ret = spi_flash_write(env_flash, offset + off, blk, buf + off);
+		if (ret)
+			break;
+		written++;
+	}
+	free(old);
+
+	if (ret)
+		return -1;
+
+	printf("%u of %u\n", written, size / blk);
+	return 0;
+}
+
 int sf_saveenv(void)
 {
 	u32	saved_size = 0, saved_offset = 0, sector = 1;
@@ -224,6 +274,9 @@ int sf_saveenv(void)
 	int	ret = 1;
 	env_t	env_new;
 
+	if (!env_needs_save())
+		return 0;
+
 	env_flash = spi_flash_probe(CONFIG_SF_DEFAULT_BUS,
 		CONFIG_SF_DEFAULT_CS,
 		CONFIG_SF_DEFAULT_SPEED, CONFIG_SF_DEFAULT_MODE);
@@ -255,6 +308,13 @@ int sf_saveenv(void)
 	if (ret)
 		goto done;
 
+	if (!saved_buffer) {
+		ret = sf_env_write_changed(CONFIG_ENV_OFFSET, CONFIG_ENV_RANGE,
+				(char *)&env_new);
+		if (ret <= 0)
+			goto done;
+	}
+
 	puts("Erasing SPI flash...");
 	ret = spi_flash_erase(env_flash, CONFIG_ENV_OFFSET,
 		CONFIG_ENV_RANGE);
@@ -281,6 +341,9 @@ int sf_saveenv(void)
 	if (saved_buffer)
 		free(saved_buffer);
 
+	if (!ret)
+		env_htab.dirty = 0;
+
 	return ret;
 }
 
@@ -938,6 +938,60 @@ int calculate_hash(const void *data, int data_len, const char *algo,
 	return 0;
 }
 
+#ifndef USE_HOSTCC
+static struct {
+	const void *fit;
+	int noffset;
+	int value_len;
+	uint8_t value[FIT_MAX_HASH_LEN];
+} fit_preverified[FIT_MAX_PREVERIFIED];
+
+void fit_image_hash_set_verified(const void *fit, int noffset,
+				 const uint8_t *value, int value_len)
+{
+	int i;
+
+	if (value_len > FIT_MAX_HASH_LEN)
+		return;
+
+	for (i = 0; i < FIT_MAX_PREVERIFIED; i++) {
+		if (!fit_preverified[i].fit) {
+			fit_preverified[i].fit = fit;
+			fit_preverified[i].noffset = noffset;
+			fit_preverified[i].value_len = value_len;
+			memcpy(fit_preverified[i].value, value, value_len);
+			return;
+		}
+	}
+}
+
+void fit_image_hash_clear_verified(void)
+{
+	memset(fit_preverified, 0, sizeof(fit_preverified));
+}
+
+/* Consume a fit_image_hash_set_verified() record matching the hash node */
+static int fit_image_hash_preverified(const void *fit, int noffset,
+				      const uint8_t *fit_value,
+				      int fit_value_len)
+{
+	int i, match;
+
+	for (i = 0; i < FIT_MAX_PREVERIFIED; i++) {
+		if (fit_preverified[i].fit != fit ||
+		    fit_preverified[i].noffset != noffset)
+			continue;
+
+		match = fit_preverified[i].value_len == fit_value_len &&
+			!memcmp(fit_preverified[i].value, fit_value,
+				fit_value_len);
+		fit_preverified[i].fit = NULL;
+		return match;
+	}
+	return 0;
+}
+#endif
+
 static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 				size_t size, char **err_msgp)
 {
@@ -977,6 +1031,11 @@ static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 		return -1;
 	}
 
+#ifndef USE_HOSTCC
+	if (fit_image_hash_preverified(fit, noffset, fit_value, fit_value_len))
+		return 0;
+#endif
+
 	if (calculate_hash(data, size, algo, value, &value_len)) {
 		*err_msgp = "Unsupported hash algorithm";
 		return -1;
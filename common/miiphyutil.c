@@ -19,6 +19,9 @@
 #include <linux/list.h>
 #include <malloc.h>
 #include <net.h>
+#ifdef CONFIG_IPQ_LAZY_INIT
+#include <asm/arch-qca-common/qca_common.h>
+#endif
 
 /* local debug macro */
 #undef MII_DEBUG
@@ -271,6 +274,10 @@ const char *miiphy_get_current_dev(void)
 
 static struct mii_dev *miiphy_get_active_dev(const char *devname)
 {
+#ifdef CONFIG_IPQ_LAZY_INIT
+	/* The buses are only registered once net is up */
+	ipq_lazy_init(IPQ_LAZY_NET);
+#endif
 	/* If the current mii is the one we want, return it */
 	if (current_mii)
 		if (strcmp(current_mii->name, devname) == 0)
@@ -228,6 +228,13 @@ static int usb_stor_probe_device(struct usb_device *dev)
 
 void usb_stor_reset(void)
 {
+#ifdef CONFIG_EFI_PARTITION
+	int i;
+
+	/* The devices may be gone or swapped, forget their partitions */
+	for (i = 0; i < usb_max_devs; i++)
+		gpt_cache_invalidate(&usb_dev_desc[i]);
+#endif
 	usb_max_devs = 0;
 }
 
@@ -1162,6 +1169,9 @@ retry_it:
 		buf_addr += srb->datalen;
 	} while (blks != 0);
 	ss->flags &= ~USB_READY;
+#ifdef CONFIG_EFI_PARTITION
+	gpt_cache_write_notify(&usb_dev_desc[device], blknr, blkcnt);
+#endif
 
 	debug("usb_write: end startblk " LBAF ", blccnt %x buffer %"
 	      PRIxPTR "\n", start, smallblks, buf_addr);
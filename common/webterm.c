@@ -9,12 +9,18 @@
 #include "../failsafe/failsafe_httpd.h"
 #include "../failsafe/failsafe_httpd_types.h"
 #include <net.h>
+#include "lwip/timeouts.h"
 
 /* Web terminal buffer size */
 #define WEBTERM_BUFFER_SIZE 16384
 #define WEBTERM_LINE_SIZE 256
 #define WEBTERM_RESPONSE_SIZE 32768
 #define WEBTERM_MAX_CMD_LEN 4096
+#define WEBTERM_STREAM_CHUNK 4096
+/* "%x\r\n" chunk size line plus the trailing "\r\n" */
+#define WEBTERM_STREAM_OVERHEAD 8
+/* Minimum time between network polls while a command is running */
+#define WEBTERM_YIELD_MS 10
 
 /* Circular buffer for console output */
 struct webterm_buffer {
@@ -36,9 +42,18 @@ static char webterm_pending_cmd[WEBTERM_MAX_CMD_LEN] = {0};
 static volatile int webterm_has_pending_cmd = 0;
 volatile int webterm_abort_requested = 0;
 
+static int webterm_cmd_running;
+static int webterm_yield_busy;
+static ulong webterm_yield_time;
+
 static char webterm_response_buf[WEBTERM_RESPONSE_SIZE];
 static char webterm_output_buf[WEBTERM_BUFFER_SIZE];
 
+/* Connection receiving /webterm/stream, drains webterm_out directly */
+static struct failsafe_httpd_state *webterm_stream_hs;
+static int webterm_stream_busy;
+static char webterm_stream_buf[WEBTERM_STREAM_CHUNK + WEBTERM_STREAM_OVERHEAD];
+
 /* Forward declaration */
 void webterm_capture_output(const char *str);
 
@@ -67,6 +82,7 @@ int webterm_init(void) {
 }
 
 static void webterm_batch_copy(const char *src, int len);
+void webterm_stream_poll(void);
 
 static void webterm_flush_line(void) {
 	char formatted_line[WEBTERM_LINE_SIZE + 2];
@@ -218,14 +234,40 @@ int webterm_run_pending_command(void) {
 	webterm_has_pending_cmd = 0;
 	webterm_abort_requested = 0;
 	strcpy(cmd_copy, webterm_pending_cmd);
+	webterm_cmd_running = 1;
+	webterm_yield_time = get_timer(0);
 	run_command(cmd_copy, 0);
+	webterm_cmd_running = 0;
 	webterm_flush_line_buffer();
 	return 1;
 }
 
+int webterm_command_running(void) {
+	return webterm_cmd_running;
+}
+
+/*
+ * Called through cond_resched() from flash/MMC/UBI loops. While a web
+ * terminal command is running this keeps lwIP fed so connections stay
+ * alive, output is streamed and abort requests get through to ctrlc().
+ */
+void webterm_yield(void) {
+	if (!webterm_cmd_running || webterm_yield_busy ||
+		get_timer(webterm_yield_time) < WEBTERM_YIELD_MS)
+		return;
+
+	webterm_yield_busy = 1;
+	eth_rx();
+	sys_check_timeouts();
+	webterm_stream_poll();
+	webterm_yield_time = get_timer(0);
+	webterm_yield_busy = 0;
+}
+
 static void webterm_respond(struct failsafe_httpd_state *hs, int code, const char *ctype, const char *fmt, ...) {
 	va_list ap;
-	const char *reason = code == 200 ? "OK" : "Method Not Allowed";
+	const char *reason = code == 200 ? "OK" :
+		code == 405 ? "Method Not Allowed" : "Service Unavailable";
 	int hlen = snprintf(webterm_response_buf, sizeof(webterm_response_buf),
 		"HTTP/1.1 %d %s\r\nContent-Type: %s\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n",
 		code, reason, ctype);
@@ -238,6 +280,96 @@ static void webterm_respond(struct failsafe_httpd_state *hs, int code, const cha
 	httpd_send_data(hs);
 }
 
+/*
+ * Push buffered console output to the stream client as HTTP chunks.
+ * Only as much as fits into the TCP send buffer is taken out of the
+ * ring; the rest stays queued until httpd_sent() reports free space.
+ * Never called from the console hook, which may run inside lwIP.
+ */
+void webterm_stream_poll(void) {
+	struct failsafe_httpd_state *hs = webterm_stream_hs;
+	struct tcp_pcb *pcb;
+	int room, len, hlen, sent = 0;
+
+	if (!hs || webterm_stream_busy)
+		return;
+
+	webterm_stream_busy = 1;
+	pcb = hs->pcb;
+	while (webterm_out.count > 0) {
+		room = (int)tcp_sndbuf(pcb) - WEBTERM_STREAM_OVERHEAD;
+		if (room <= 0 || tcp_sndqueuelen(pcb) >= TCP_SND_QUEUELEN - 1)
+			break;
+
+		len = min(webterm_out.count, webterm_out.size - webterm_out.tail);
+		len = min(len, min(room, WEBTERM_STREAM_CHUNK));
+
+		hlen = sprintf(webterm_stream_buf, "%x\r\n", len);
+		memcpy(webterm_stream_buf + hlen, &webterm_out.buffer[webterm_out.tail], len);
+		memcpy(webterm_stream_buf + hlen + len, "\r\n", 2);
+		if (tcp_write(pcb, webterm_stream_buf, hlen + len + 2, TCP_WRITE_FLAG_COPY) != ERR_OK)
+			break;
+
+		webterm_out.tail = (webterm_out.tail + len) % webterm_out.size;
+		webterm_out.count -= len;
+		sent = 1;
+	}
+
+	if (sent) {
+		tcp_output(pcb);
+		hs->last_activity = (u32_t)get_timer(0);
+	}
+	webterm_stream_busy = 0;
+}
+
+/* Called by the httpd when the stream connection goes away */
+void webterm_stream_detach(struct failsafe_httpd_state *hs) {
+	if (webterm_stream_hs == hs)
+		webterm_stream_hs = NULL;
+}
+
+/* Called when the httpd shuts down, its pcbs are gone */
+void webterm_stream_stop(void) {
+	webterm_stream_hs = NULL;
+}
+
+/* Terminate the chunked body and let the httpd close the connection */
+static void webterm_stream_close(struct failsafe_httpd_state *hs) {
+	static const char last_chunk[] = "0\r\n\r\n";
+
+	webterm_stream_detach(hs);
+	hs->state = STATE_FILE_REQUEST;
+	hs->dataptr = (u8_t *)last_chunk;
+	hs->upload = sizeof(last_chunk) - 1;
+	httpd_send_data(hs);
+}
+
+static void webterm_stream_open(struct failsafe_httpd_state *hs) {
+	static const char header[] =
+		"HTTP/1.1 200 OK\r\nContent-Type: text/plain; charset=utf-8\r\n"
+		"Cache-Control: no-cache\r\nTransfer-Encoding: chunked\r\n"
+		"Connection: close\r\n\r\n";
+
+	/* Only one client consumes the ring buffer, newest one wins */
+	if (webterm_stream_hs && webterm_stream_hs != hs)
+		webterm_stream_close(webterm_stream_hs);
+
+	if (tcp_write(hs->pcb, header, sizeof(header) - 1, 0) != ERR_OK) {
+		webterm_respond(hs, 503, "text/plain", "Busy\n");
+		return;
+	}
+
+	tcp_nagle_disable(hs->pcb);
+	hs->state = STATE_STREAM;
+	hs->dataptr = NULL;
+	hs->upload = 0;
+	webterm_stream_hs = hs;
+
+	webterm_flush_line_buffer();
+	webterm_stream_poll();
+	tcp_output(hs->pcb);
+}
+
 static int webterm_parse_post_body(char *data, int data_len, char *out, int out_size) {
 	char *body = strstr(data, "\r\n\r\n");
 	int header_len, body_len;
@@ -302,6 +434,8 @@ void webterm_http_handler(struct failsafe_httpd_state *hs, char *data, int data_
 	} else if (strncmp(path, "status", 6) == 0) {
 		webterm_flush_line_buffer();
 		webterm_respond(hs, 200, "text/plain", "%d", webterm_output_seq);
+	} else if (strncmp(path, "stream", 6) == 0) {
+		webterm_stream_open(hs);
 	} else if (strncmp(path, "data", 4) == 0) {
 		webterm_flush_line_buffer();
 		int out_len = webterm_get_output(webterm_output_buf, sizeof(webterm_output_buf));
@@ -180,6 +180,109 @@ static void prepare_backup_gpt_header(gpt_header *gpt_h)
 }
 
 #ifdef CONFIG_EFI_PARTITION
+/*
+ * Validated GPTs, one slot per block device. Partition lookups by number
+ * or name are served from here instead of re-reading and CRC checking
+ * the whole table from the medium every time. Writes through this file
+ * and block writes touching the GPT areas drop the device's slot.
+ */
+#define GPT_CACHE_SLOTS		2
+/* MBR + header + 128 entries with 512 byte blocks, an upper bound */
+#define GPT_CACHE_AREA_BLKS	34
+
+static struct gpt_cache {
+	block_dev_desc_t *dev_desc;
+	lbaint_t lba;
+	gpt_header *gpt_head;
+	gpt_entry *gpt_pte;
+} gpt_cache[GPT_CACHE_SLOTS];
+static int gpt_cache_victim;
+
+static void gpt_cache_drop(struct gpt_cache *c)
+{
+	free(c->gpt_head);
+	free(c->gpt_pte);
+	memset(c, 0, sizeof(*c));
+}
+
+/**
+ * gpt_cache_get() - return the validated GPT of a block device
+ *
+ * Reads and validates the primary (or, failing that, the backup) GPT on
+ * the first call for @dev_desc and keeps it. The returned header and
+ * entries belong to the cache and must not be freed.
+ *
+ * @return - zero on success, otherwise error
+ */
+static int gpt_cache_get(block_dev_desc_t *dev_desc, const char *caller,
+			 gpt_header **gpt_head, gpt_entry **gpt_pte)
+{
+	struct gpt_cache *c;
+	gpt_header *head;
+	gpt_entry *pte = NULL;
+	int i;
+
+	for (i = 0; i < GPT_CACHE_SLOTS; i++) {
+		c = &gpt_cache[i];
+		if (c->dev_desc == dev_desc && c->lba == dev_desc->lba) {
+			*gpt_head = c->gpt_head;
+			*gpt_pte = c->gpt_pte;
+			return 0;
+		}
+	}
+
+	head = memalign(ARCH_DMA_MINALIGN,
+			PAD_TO_BLOCKSIZE(sizeof(gpt_header), dev_desc));
+	if (!head)
+		return -1;
+
+	/* This function validates AND fills in the GPT header and PTE */
+	if (is_gpt_valid(dev_desc, GPT_PRIMARY_PARTITION_TABLE_LBA,
+			 head, &pte) != 1) {
+		printf("%s: *** ERROR: Invalid GPT ***\n", caller);
+		if (is_gpt_valid(dev_desc, (dev_desc->lba - 1),
+				 head, &pte) != 1) {
+			printf("%s: *** ERROR: Invalid Backup GPT ***\n",
+			       caller);
+			free(head);
+			return -1;
+		} else {
+			printf("%s: ***        Using Backup GPT ***\n",
+			       caller);
+		}
+	}
+
+	c = &gpt_cache[gpt_cache_victim];
+	gpt_cache_victim = (gpt_cache_victim + 1) % GPT_CACHE_SLOTS;
+	gpt_cache_drop(c);
+	c->dev_desc = dev_desc;
+	c->lba = dev_desc->lba;
+	c->gpt_head = head;
+	c->gpt_pte = pte;
+
+	*gpt_head = head;
+	*gpt_pte = pte;
+	return 0;
+}
+
+void gpt_cache_invalidate(block_dev_desc_t *dev_desc)
+{
+	int i;
+
+	for (i = 0; i < GPT_CACHE_SLOTS; i++)
+		if (!dev_desc || gpt_cache[i].dev_desc == dev_desc)
+			gpt_cache_drop(&gpt_cache[i]);
+}
+
+void gpt_cache_write_notify(block_dev_desc_t *dev_desc, lbaint_t start,
+			    lbaint_t blkcnt)
+{
+	/* Protective MBR + primary GPT, and the backup GPT at the end */
+	if (start < GPT_CACHE_AREA_BLKS ||
+	    start + blkcnt > dev_desc->lba - GPT_CACHE_AREA_BLKS)
+		gpt_cache_invalidate(dev_desc);
+}
+
 /*
  * Public Functions (include/part.h)
  */
@@ -248,8 +351,8 @@ void print_part_efi(block_dev_desc_t * dev_desc)
 int get_partition_info_efi(block_dev_desc_t * dev_desc, int part,
 				disk_partition_t * info)
 {
-	ALLOC_CACHE_ALIGN_BUFFER_PAD(gpt_header, gpt_head, 1, dev_desc->blksz);
-	gpt_entry *gpt_pte = NULL;
+	gpt_header *gpt_head;
+	gpt_entry *gpt_pte;
 
 	/* "part" argument must be at least 1 */
 	if (!dev_desc || !info || part < 1) {
@@ -257,26 +360,13 @@ int get_partition_info_efi(block_dev_desc_t * dev_desc, int part,
 		return -1;
 	}
 
-	/* This function validates AND fills in the GPT header and PTE */
-	if (is_gpt_valid(dev_desc, GPT_PRIMARY_PARTITION_TABLE_LBA,
-			gpt_head, &gpt_pte) != 1) {
-		printf("%s: *** ERROR: Invalid GPT ***\n", __func__);
-		if (is_gpt_valid(dev_desc, (dev_desc->lba - 1),
-				 gpt_head, &gpt_pte) != 1) {
-			printf("%s: *** ERROR: Invalid Backup GPT ***\n",
-			       __func__);
-			return -1;
-		} else {
-			printf("%s: ***        Using Backup GPT ***\n",
-			       __func__);
-		}
-	}
+	if (gpt_cache_get(dev_desc, __func__, &gpt_head, &gpt_pte))
+		return -1;
 
 	if (part > le32_to_cpu(gpt_head->num_partition_entries) ||
 	    !is_pte_valid(&gpt_pte[part - 1])) {
 		debug("%s: *** ERROR: Invalid partition number %d ***\n",
 			__func__, part);
-		free(gpt_pte);
 		return -1;
 	}
 
@@ -304,25 +394,29 @@ int get_partition_info_efi(block_dev_desc_t * dev_desc, int part,
 	debug("%s: start 0x" LBAF ", size 0x" LBAF ", name %s\n", __func__,
 	      info->start, info->size, info->name);
 
-	/* Remember to free pte */
-	free(gpt_pte);
 	return 0;
 }
 
 int get_partition_info_efi_by_name(block_dev_desc_t *dev_desc,
 	const char *name, disk_partition_t *info)
 {
-	int ret;
-	int i;
-	for (i = 1; i < GPT_ENTRY_NUMBERS; i++) {
-		ret = get_partition_info_efi(dev_desc, i, info);
-		if (ret != 0) {
+	gpt_header *gpt_head;
+	gpt_entry *gpt_pte;
+	int i, count;
+
+	if (!dev_desc || gpt_cache_get(dev_desc, __func__, &gpt_head, &gpt_pte))
+		return -1;
+
+	count = min((int)le32_to_cpu(gpt_head->num_partition_entries),
+		    GPT_ENTRY_NUMBERS - 1);
+	for (i = 0; i < count; i++) {
+		if (!is_pte_valid(&gpt_pte[i])) {
 			/* no more entries in table */
 			return -1;
 		}
-		if (strcmp(name, (const char *)info->name) == 0) {
+		if (strcmp(name, print_efiname(&gpt_pte[i])) == 0) {
 			/* matched */
-			return 0;
+			return get_partition_info_efi(dev_desc, i + 1, info);
 		}
 	}
 	return -2;
@@ -342,32 +436,17 @@ int test_part_efi(block_dev_desc_t * dev_desc)
 
 int get_partition_count_efi(block_dev_desc_t * dev_desc)
 {
-	ALLOC_CACHE_ALIGN_BUFFER_PAD(gpt_header, gpt_head, 1, dev_desc->blksz);
-	gpt_entry *gpt_pte = NULL;
+	gpt_header *gpt_head;
+	gpt_entry *gpt_pte;
 
 	if (!dev_desc) {
 		printf("%s: Invalid Argument(s)\n", __func__);
 		return -1;
 	}
 
-	/* This function validates AND fills in the GPT header and PTE */
-	if (is_gpt_valid(dev_desc, GPT_PRIMARY_PARTITION_TABLE_LBA,
-			gpt_head, &gpt_pte) != 1) {
-		printf("%s: *** ERROR: Invalid GPT ***\n", __func__);
-		if (is_gpt_valid(dev_desc, (dev_desc->lba - 1),
-				 gpt_head, &gpt_pte) != 1) {
-			printf("%s: *** ERROR: Invalid Backup GPT ***\n",
-			       __func__);
-			if (gpt_pte != NULL)
-				free(gpt_pte);
-			return -1;
-		} else {
-			printf("%s: ***        Using Backup GPT ***\n",
-			       __func__);
-		}
-	}
+	if (gpt_cache_get(dev_desc, __func__, &gpt_head, &gpt_pte))
+		return -1;
 
-	free(gpt_pte);
 	return le32_to_cpu(gpt_head->num_partition_entries);
 }
 
@@ -411,6 +490,8 @@ int write_gpt_table(block_dev_desc_t *dev_desc,
 	u32 calc_crc32;
 
 	debug("max lba: %x\n", (u32) dev_desc->lba);
+	gpt_cache_invalidate(dev_desc);
+
 	/* Setup the Protective MBR */
 	if (set_protective_mbr(dev_desc) < 0)
 		goto err;
@@ -763,6 +844,8 @@ int write_mbr_and_gpt_partitions(block_dev_desc_t *dev_desc, void *buf)
 	if (is_valid_gpt_buf(dev_desc, buf))
 		return -1;
 
+	gpt_cache_invalidate(dev_desc);
+
 	/* determine start of GPT Header in the buffer */
 	gpt_h = buf + (GPT_PRIMARY_PARTITION_TABLE_LBA *
 		       dev_desc->blksz);
@@ -402,8 +402,13 @@ int bam_add_one_desc(struct bam_instance *bam,
 	desc->reserved = 0;
 
 #if !defined(CONFIG_SYS_DCACHE_OFF)
-	flush_dcache_range((addr_t)desc, ((addr_t)desc + BAM_DESC_SIZE));
-	flush_dcache_range((addr_t)data_ptr, (addr_t)data_ptr + len);
+	/* Descriptors and buffers in uncached memory need no flush */
+	if (!noncached_range((addr_t)desc, BAM_DESC_SIZE))
+		flush_dcache_range((addr_t)desc,
+				   ((addr_t)desc + BAM_DESC_SIZE));
+	if (!noncached_range((addr_t)data_ptr, len))
+		flush_dcache_range((addr_t)data_ptr,
+				   (addr_t)data_ptr + len);
 #endif
 
 	/* Update the FIFO to point to the head */
@@ -431,7 +436,8 @@ struct cmd_element* bam_add_cmd_element(struct cmd_element *ptr,
 	ptr->reg_data = value;
 
 #if !defined(CONFIG_SYS_DCACHE_OFF)
-	if(cmd_type == CE_READ_TYPE)
+	if (cmd_type == CE_READ_TYPE &&
+	    !noncached_range((addr_t)value, sizeof(uint32_t)))
 		flush_dcache_range((addr_t)value,
 					((addr_t)value + sizeof(uint32_t)));
 #endif
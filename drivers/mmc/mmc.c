@@ -17,6 +17,7 @@
 #include <part.h>
 #include <malloc.h>
 #include <memalign.h>
+#include <linux/compat.h>
 #include <linux/list.h>
 #include <div64.h>
 #include "mmc_private.h"
@@ -53,11 +54,22 @@ __weak int board_mmc_getcd(struct mmc *mmc)
 int mmc_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *data)
 {
 	int ret;
-
 #ifdef CONFIG_MMC_TRACE
 	int i;
 	u8 *ptr;
+#endif
+
+	/*
+	 * A command issued while a split read is in flight, e.g. by a
+	 * handler run from the reader's yield, waits for that read to land
+	 * and be stopped. Otherwise it would take the read's completion and
+	 * reuse the host's DMA descriptors under it.
+	 */
+	if (mmc->async_busy)
+		while (mmc_bread_poll(mmc->block_dev.dev) == -EBUSY)
+			;
 
+#ifdef CONFIG_MMC_TRACE
 	printf("CMD_SEND:%d\n", cmd->cmdidx);
 	printf("\t\tARG\t\t\t 0x%08X\n", cmd->cmdarg);
 	ret = mmc->cfg->ops->send_cmd(mmc, cmd, data);
@@ -193,47 +205,152 @@ struct mmc *find_mmc_device(int dev_num)
 	return NULL;
 }
 
-static int mmc_read_blocks(struct mmc *mmc, void *dst, lbaint_t start,
-			   lbaint_t blkcnt)
+static void mmc_prep_read(struct mmc *mmc, struct mmc_cmd *cmd,
+			  struct mmc_data *data, void *dst, lbaint_t start,
+			  lbaint_t blkcnt)
 {
-	struct mmc_cmd cmd;
-	struct mmc_data data;
-
 	if (blkcnt > 1)
-		cmd.cmdidx = MMC_CMD_READ_MULTIPLE_BLOCK;
+		cmd->cmdidx = MMC_CMD_READ_MULTIPLE_BLOCK;
 	else
-		cmd.cmdidx = MMC_CMD_READ_SINGLE_BLOCK;
+		cmd->cmdidx = MMC_CMD_READ_SINGLE_BLOCK;
 
 	if (mmc->high_capacity)
-		cmd.cmdarg = start;
+		cmd->cmdarg = start;
 	else
-		cmd.cmdarg = start * mmc->read_bl_len;
+		cmd->cmdarg = start * mmc->read_bl_len;
 
-	cmd.resp_type = MMC_RSP_R1;
+	cmd->resp_type = MMC_RSP_R1;
 
-	data.dest = dst;
-	data.blocks = blkcnt;
-	data.blocksize = mmc->read_bl_len;
-	data.flags = MMC_DATA_READ;
+	data->dest = dst;
+	data->blocks = blkcnt;
+	data->blocksize = mmc->read_bl_len;
+	data->flags = MMC_DATA_READ;
+}
 
-	if (mmc_send_cmd(mmc, &cmd, &data))
-		return 0;
+static int mmc_stop_read(struct mmc *mmc)
+{
+	struct mmc_cmd cmd;
 
-	if (blkcnt > 1) {
-		cmd.cmdidx = MMC_CMD_STOP_TRANSMISSION;
-		cmd.cmdarg = 0;
-		cmd.resp_type = MMC_RSP_R1b;
-		if (mmc_send_cmd(mmc, &cmd, NULL)) {
+	cmd.cmdidx = MMC_CMD_STOP_TRANSMISSION;
+	cmd.cmdarg = 0;
+	cmd.resp_type = MMC_RSP_R1b;
+	if (mmc_send_cmd(mmc, &cmd, NULL)) {
 #if !defined(CONFIG_SPL_BUILD) || defined(CONFIG_SPL_LIBCOMMON_SUPPORT)
-			printf("mmc fail to send stop cmd\n");
+		printf("mmc fail to send stop cmd\n");
 #endif
-			return 0;
-		}
+		return -1;
 	}
 
+	return 0;
+}
+
+static int mmc_read_blocks(struct mmc *mmc, void *dst, lbaint_t start,
+			   lbaint_t blkcnt)
+{
+	struct mmc_cmd cmd;
+	struct mmc_data data;
+
+	mmc_prep_read(mmc, &cmd, &data, dst, start, blkcnt);
+
+	if (mmc_send_cmd(mmc, &cmd, &data))
+		return 0;
+
+	if (blkcnt > 1 && mmc_stop_read(mmc))
+		return 0;
+
 	return blkcnt;
 }
 
+/*
+ * Split-phase block read. mmc_bread_start() issues one multi-block read
+ * of at most cfg->b_max blocks and returns while the host DMAs the data;
+ * mmc_bread_poll() reports -EBUSY until it has landed, and
+ * mmc_bread_finish() waits for it and returns the number of blocks read.
+ * Only one request per device can be outstanding. Hosts without
+ * send_cmd_async complete the read inside mmc_bread_start().
+ */
+int mmc_bread_start(int dev_num, lbaint_t start, lbaint_t blkcnt, void *dst)
+{
+	struct mmc *mmc = find_mmc_device(dev_num);
+	struct mmc_cmd cmd;
+	struct mmc_data data;
+
+	if (!mmc || mmc->async_blkcnt || blkcnt == 0 ||
+	    blkcnt > mmc->cfg->b_max || start + blkcnt > mmc->block_dev.lba)
+		return -EINVAL;
+
+	if (mmc_set_blocklen(mmc, mmc->read_bl_len))
+		return -EIO;
+
+	mmc->async_dst = dst;
+	mmc->async_blkcnt = blkcnt;
+	mmc->async_busy = 0;
+	mmc->async_err = 0;
+
+#if !defined(CONFIG_SYS_DCACHE_OFF)
+	flush_cache((unsigned long)dst, blkcnt * mmc->read_bl_len);
+#endif
+	if (!mmc->cfg->ops->send_cmd_async) {
+		if (mmc_read_blocks(mmc, dst, start, blkcnt) != blkcnt)
+			mmc->async_err = -EIO;
+		return 0;
+	}
+
+	mmc_prep_read(mmc, &cmd, &data, dst, start, blkcnt);
+	if (mmc->cfg->ops->send_cmd_async(mmc, &cmd, &data)) {
+		mmc->async_blkcnt = 0;
+		return -EIO;
+	}
+	mmc->async_busy = 1;
+
+	return 0;
+}
+
+int mmc_bread_poll(int dev_num)
+{
+	struct mmc *mmc = find_mmc_device(dev_num);
+	int err;
+
+	if (!mmc || !mmc->async_blkcnt)
+		return -EINVAL;
+
+	if (mmc->async_busy) {
+		err = mmc->cfg->ops->data_poll(mmc);
+		if (err == -EBUSY)
+			return err;
+
+		mmc->async_busy = 0;
+		if (err)
+			mmc->async_err = -EIO;
+		else if (mmc->async_blkcnt > 1 && mmc_stop_read(mmc))
+			mmc->async_err = -EIO;
+#if !defined(CONFIG_SYS_DCACHE_OFF)
+		flush_cache((unsigned long)mmc->async_dst,
+			    mmc->async_blkcnt * mmc->read_bl_len);
+#endif
+	}
+
+	return mmc->async_err;
+}
+
+ulong mmc_bread_finish(int dev_num)
+{
+	struct mmc *mmc = find_mmc_device(dev_num);
+	lbaint_t blkcnt;
+	int err;
+
+	if (!mmc || !mmc->async_blkcnt)
+		return 0;
+
+	while ((err = mmc_bread_poll(dev_num)) == -EBUSY)
+		cond_resched();
+
+	blkcnt = mmc->async_blkcnt;
+	mmc->async_blkcnt = 0;
+
+	return err ? 0 : blkcnt;
+}
+
 static ulong mmc_bread(int dev_num, lbaint_t start, lbaint_t blkcnt, void *dst)
 {
 	lbaint_t cur, blocks_todo = blkcnt;
@@ -270,6 +387,7 @@ static ulong mmc_bread(int dev_num, lbaint_t start, lbaint_t blkcnt, void *dst)
 		blocks_todo -= cur;
 		start += cur;
 		dst += cur * mmc->read_bl_len;
+		cond_resched();
 	} while (blocks_todo > 0);
 #if !defined(CONFIG_SYS_DCACHE_OFF)
 	flush_cache((unsigned long)dst - ( blkcnt * mmc->read_bl_len),
@@ -1510,6 +1628,9 @@ static int mmc_startup(struct mmc *mmc)
 	mmc->block_dev.revision[0] = 0;
 #endif
 #if !defined(CONFIG_SPL_BUILD) || defined(CONFIG_SPL_LIBDISK_SUPPORT)
+#ifdef CONFIG_EFI_PARTITION
+	gpt_cache_invalidate(&mmc->block_dev);
+#endif
 	init_part(&mmc->block_dev);
 #endif
 	/* Add device specific quirks */
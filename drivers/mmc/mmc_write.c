@@ -11,6 +11,7 @@
 #include <common.h>
 #include <part.h>
 #include <div64.h>
+#include <linux/compat.h>
 #include <linux/math64.h>
 #include <linux/log2.h>
 #include "mmc_private.h"
@@ -80,6 +81,10 @@ unsigned long mmc_berase(int dev_num, lbaint_t start, lbaint_t blkcnt)
 	if (!mmc)
 		return -1;
 
+#if defined(CONFIG_EFI_PARTITION) && !defined(CONFIG_SPL_BUILD)
+	gpt_cache_write_notify(&mmc->block_dev, start, blkcnt);
+#endif
+
 	timeout = mmc->trim_timeout;
 	if (!(mmc->sec_feature_support & EXT_CSD_SEC_ER_EN)) {
 		return -1;
@@ -136,6 +141,7 @@ unsigned long mmc_berase(int dev_num, lbaint_t start, lbaint_t blkcnt)
 			/* Waiting for the ready status */
 			if (mmc_send_status(mmc, timeout))
 				return 0;
+			cond_resched();
 		}
 
 		return blk;
@@ -178,6 +184,73 @@ unsigned long mmc_berase(int dev_num, lbaint_t start, lbaint_t blkcnt)
 	return blk;
 }
 
+/*
+ * Clear a block range with a single TRIM. Unlike mmc_berase() this needs
+ * no erase group alignment and the card only unmaps the range instead of
+ * erasing it group by group, so even a large partition clears in one
+ * command. Cards without TRIM support fall back to mmc_berase().
+ */
+unsigned long mmc_btrim(int dev_num, lbaint_t start, lbaint_t blkcnt)
+{
+	struct mmc *mmc = find_mmc_device(dev_num);
+	lbaint_t qty;
+	ulong timeout;
+
+	if (!mmc)
+		return -1;
+
+	if (!blkcnt)
+		return 0;
+
+	if (IS_SD(mmc) || !(mmc->sec_feature_support & EXT_CSD_SEC_GB_CL_EN))
+		return mmc_berase(dev_num, start, blkcnt);
+
+#if defined(CONFIG_EFI_PARTITION) && !defined(CONFIG_SPL_BUILD)
+	gpt_cache_write_notify(&mmc->block_dev, start, blkcnt);
+#endif
+
+	qty = blkcnt / mmc->erase_grp_size + 1;
+	timeout = (ulong)mmc->trim_timeout * qty;
+	if (timeout > MMC_TRIM_MAX_TIMEOUT)
+		timeout = MMC_TRIM_MAX_TIMEOUT;
+
+	if (mmc_erase_t(mmc, start, blkcnt, MMC_TRIM_ARG))
+		return 0;
+
+	/* Waiting for the ready status */
+	if (mmc_send_status(mmc, timeout))
+		return 0;
+
+	return blkcnt;
+}
+
+/*
+ * Ask the card to physically purge everything previously trimmed or
+ * erased. This can take minutes, so it is only done on request.
+ */
+int mmc_sanitize(struct mmc *mmc)
+{
+	struct mmc_cmd cmd;
+	int err;
+
+	if (!(mmc->sec_feature_support & EXT_CSD_SEC_SANITIZE)) {
+		puts("Card does not support sanitize\n");
+		return -1;
+	}
+
+	cmd.cmdidx = MMC_CMD_SWITCH;
+	cmd.resp_type = MMC_RSP_R1b;
+	cmd.cmdarg = (MMC_SWITCH_MODE_WRITE_BYTE << 24) |
+		     (EXT_CSD_SANITIZE_START << 16) | (1 << 8);
+
+	/* The host may give up on the busy signal long before the card */
+	err = mmc_send_cmd(mmc, &cmd, NULL);
+	if (err && err != TIMEOUT)
+		return err;
+
+	return mmc_send_status(mmc, MMC_SANITIZE_TIMEOUT);
+}
+
 static ulong mmc_write_blocks(struct mmc *mmc, lbaint_t start,
 		lbaint_t blkcnt, const void *src)
 {
@@ -247,6 +320,10 @@ ulong mmc_bwrite(int dev_num, lbaint_t start, lbaint_t blkcnt, const void *src)
 	if (mmc_set_blocklen(mmc, mmc->write_bl_len))
 		return 0;
 
+#if defined(CONFIG_EFI_PARTITION) && !defined(CONFIG_SPL_BUILD)
+	gpt_cache_write_notify(&mmc->block_dev, start, blkcnt);
+#endif
+
 #if !defined(CONFIG_SYS_DCACHE_OFF)
 	flush_cache((unsigned long)src,
 		    (unsigned long)blkcnt * mmc->write_bl_len);
@@ -259,6 +336,7 @@ ulong mmc_bwrite(int dev_num, lbaint_t start, lbaint_t blkcnt, const void *src)
 		blocks_todo -= cur;
 		start += cur;
 		src += cur * mmc->write_bl_len;
+		cond_resched();
 	} while (blocks_todo > 0);
 
 	return blkcnt;
@@ -9,6 +9,7 @@
  */
 
 #include <common.h>
+#include <errno.h>
 #include <malloc.h>
 #include <mmc.h>
 #include <sdhci.h>
@@ -78,72 +79,80 @@ static void sdhci_transfer_pio(struct sdhci_host *host, struct mmc_data *data)
 }
 
 #ifdef CONFIG_MMC_ADMA
-static struct adma_desc *sdhci_prepare_descriptors(void *data, uint32_t len)
-{
-	struct adma_desc *list;
-	uint32_t list_len = 0;
-	uint32_t remain = 0;
-	uint32_t i;
-	uint32_t table_len = 0;
-
-	if (len <= SDHCI_ADMA_DESC_LINE_SZ) {
-		list = (struct adma_desc *)memalign(CACHE_LINE_SIZE,
-				sizeof(struct adma_desc));
-
-		if (!list) {
-			printf("Error allocating memory\n");
-			assert(0);
-		} else {
-			list[0].addr = (uint32_t)data;
-			list[0].len = (len < SDHCI_ADMA_DESC_LINE_SZ) ? len :
-				(SDHCI_ADMA_DESC_LINE_SZ & 0xffff);
-			list[0].tran_att = SDHCI_ADMA_TRANS_VALID |
-				SDHCI_ADMA_TRANS_DATA | SDHCI_ADMA_TRANS_END;
+/* Enough descriptors for the largest transfer the block count allows */
+#define SDHCI_ADMA_TABLE_LEN	(DIV_ROUND_UP(65535 * SDHCI_MMC_BLK_SZ, \
+				SDHCI_ADMA_DESC_LINE_SZ) * \
+				sizeof(struct adma_desc))
 
-#if !defined(CONFIG_SYS_DCACHE_OFF)
-			flush_cache((unsigned long)list,
-				    sizeof(struct adma_desc));
+static struct adma_desc *sdhci_alloc_descriptors(struct sdhci_host *host,
+						 uint32_t table_len)
+{
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	/*
+	 * Each host reuses one uncached table, so building a list costs
+	 * neither a malloc() nor a cache flush.
+	 */
+	if (!host->adma_table)
+		host->adma_table = (struct adma_desc *)noncached_alloc(
+				SDHCI_ADMA_TABLE_LEN, CACHE_LINE_SIZE);
+	if (host->adma_table && table_len <= SDHCI_ADMA_TABLE_LEN)
+		return host->adma_table;
 #endif
-		}
-	} else {
-		list_len = len / SDHCI_ADMA_DESC_LINE_SZ;
-		remain = len - (list_len * SDHCI_ADMA_DESC_LINE_SZ);
-
-		if (remain)
-			list_len++;
+	return (struct adma_desc *)memalign(CACHE_LINE_SIZE, table_len);
+}
 
-		table_len = (list_len * sizeof(struct adma_desc));
+static void sdhci_free_descriptors(struct sdhci_host *host,
+				   struct adma_desc *list)
+{
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	if (list == host->adma_table)
+		return;
+#endif
+	free(list);
+}
 
-		list = (struct adma_desc *) memalign( CACHE_LINE_SIZE, table_len);
+static struct adma_desc *sdhci_prepare_descriptors(struct sdhci_host *host,
+						   void *data, uint32_t len)
+{
+	struct adma_desc *list;
+	uint32_t list_len;
+	uint32_t i;
+	uint32_t table_len;
+
+	list_len = DIV_ROUND_UP(len, SDHCI_ADMA_DESC_LINE_SZ);
+	if (!list_len)
+		list_len = 1;
+	table_len = (list_len * sizeof(struct adma_desc));
+
+	list = sdhci_alloc_descriptors(host, table_len);
+	if (!list) {
+		printf("Allocating memory failed\n");
+		assert(0);
+		return NULL;
+	}
 
-		if (!list) {
-			printf("Allocating memory failed\n");
-			assert(0);
-		} else {
-			memset((void *)list, 0, table_len);
+	memset((void *)list, 0, table_len);
 
-			for (i = 0; i < (list_len - 1); i++) {
-				list[i].addr = (uint32_t)data;
-				list[i].len = (SDHCI_ADMA_DESC_LINE_SZ & 0xffff);
-				list[i].tran_att = SDHCI_ADMA_TRANS_VALID |
-					SDHCI_ADMA_TRANS_DATA;
-				data += SDHCI_ADMA_DESC_LINE_SZ;
-				len -= SDHCI_ADMA_DESC_LINE_SZ;
-			}
+	for (i = 0; i < (list_len - 1); i++) {
+		list[i].addr = (uint32_t)data;
+		list[i].len = (SDHCI_ADMA_DESC_LINE_SZ & 0xffff);
+		list[i].tran_att = SDHCI_ADMA_TRANS_VALID |
+			SDHCI_ADMA_TRANS_DATA;
+		data += SDHCI_ADMA_DESC_LINE_SZ;
+		len -= SDHCI_ADMA_DESC_LINE_SZ;
+	}
 
-			list[list_len - 1].addr = (uint32_t)data;
-			list[list_len - 1].len = (len < SDHCI_ADMA_DESC_LINE_SZ)
-				? len : (SDHCI_ADMA_DESC_LINE_SZ & 0xffff);
-			list[list_len - 1].tran_att = SDHCI_ADMA_TRANS_VALID |
-				SDHCI_ADMA_TRANS_DATA
-				| SDHCI_ADMA_TRANS_END;
+	list[list_len - 1].addr = (uint32_t)data;
+	list[list_len - 1].len = (len < SDHCI_ADMA_DESC_LINE_SZ)
+		? len : (SDHCI_ADMA_DESC_LINE_SZ & 0xffff);
+	list[list_len - 1].tran_att = SDHCI_ADMA_TRANS_VALID |
+		SDHCI_ADMA_TRANS_DATA
+		| SDHCI_ADMA_TRANS_END;
 
 #if !defined(CONFIG_SYS_DCACHE_OFF)
-			flush_cache((unsigned long)list, table_len);
+	if (!noncached_range((unsigned long)list, table_len))
+		flush_cache((unsigned long)list, table_len);
 #endif
-		}
-	}
-
 
 	return list;
 }
@@ -162,7 +171,7 @@ struct adma_desc *sdhci_adma_transfer(struct sdhci_host *host, struct mmc_data *
 		sz = data->blocks * SDHCI_MMC_BLK_SZ;
 
 	/* Prepare adma descriptors */
-	adma_addr = sdhci_prepare_descriptors(dataptr, sz);
+	adma_addr = sdhci_prepare_descriptors(host, dataptr, sz);
 
 	/* Write adma address to adma register */
 	sdhci_writel(host, (uint32_t) adma_addr, SDHCI_ADM_ADDR_REG);
@@ -242,9 +251,49 @@ static int sdhci_transfer_data(struct sdhci_host *host, struct mmc_data *data,
 #define CONFIG_SDHCI_CMD_MAX_TIMEOUT		5000
 #endif
 #define CONFIG_SDHCI_CMD_DEFAULT_TIMEOUT	1000
+/* Same budget as the 1000000 x 10us loop in sdhci_transfer_data() */
+#define SDHCI_DATA_TIMEOUT_MS			10000
 
-static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
-		       struct mmc_data *data)
+#ifdef CONFIG_MMC_ADMA
+/*
+ * Completion check for a data command started by sdhci_send_command_async().
+ * Returns -EBUSY while the ADMA transfer is still running.
+ */
+static int sdhci_data_poll(struct mmc *mmc)
+{
+	struct sdhci_host *host = mmc->priv;
+	unsigned int stat;
+	int ret = 0;
+
+	if (!host->adma_pending)
+		return 0;
+
+	stat = sdhci_readl(host, SDHCI_INT_STATUS);
+	if (stat & SDHCI_INT_ERROR) {
+		printf("%s: Error detected in status(0x%X)!\n",
+		       __func__, stat);
+		ret = (stat & SDHCI_INT_TIMEOUT) ? TIMEOUT : COMM_ERR;
+	} else if (!(stat & SDHCI_INT_DATA_END)) {
+		if (get_timer(host->adma_start) < SDHCI_DATA_TIMEOUT_MS)
+			return -EBUSY;
+		printf("%s: Transfer data timeout\n", __func__);
+		ret = TIMEOUT;
+	}
+
+	sdhci_writel(host, SDHCI_INT_ALL_MASK, SDHCI_INT_STATUS);
+	if (ret) {
+		sdhci_reset(host, SDHCI_RESET_CMD);
+		sdhci_reset(host, SDHCI_RESET_DATA);
+	}
+
+	sdhci_free_descriptors(host, host->adma_pending);
+	host->adma_pending = NULL;
+	return ret;
+}
+#endif
+
+static int sdhci_issue_command(struct mmc *mmc, struct mmc_cmd *cmd,
+		       struct mmc_data *data, int async)
 {
 	struct sdhci_host *host = mmc->priv;
 	unsigned int stat = 0;
@@ -259,6 +308,12 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 	/* Timeout unit - ms */
 	static unsigned int cmd_timeout = CONFIG_SDHCI_CMD_DEFAULT_TIMEOUT;
 
+#ifdef CONFIG_MMC_ADMA
+	/* A split transfer must finish before the next command goes out */
+	while (sdhci_data_poll(mmc) == -EBUSY)
+		;
+#endif
+
 	sdhci_writel(host, SDHCI_INT_ALL_MASK, SDHCI_INT_STATUS);
 
 	mask = SDHCI_CMD_INHIBIT;
@@ -399,6 +454,15 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 	} else
 		ret = -1;
 
+#ifdef CONFIG_MMC_ADMA
+	if (!ret && data && async) {
+		/* Leave the data phase running, see sdhci_data_poll() */
+		host->adma_pending = adma_addr;
+		host->adma_start = get_timer(0);
+		return 0;
+	}
+#endif
+
 	if (!ret && data)
 		ret = sdhci_transfer_data(host, data, start_addr);
 
@@ -422,11 +486,27 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 	else
 		ret = COMM_ERR;
 end:
+#ifdef CONFIG_MMC_ADMA
 	if (adma_addr)
-		free(adma_addr);
+		sdhci_free_descriptors(host, adma_addr);
+#endif
 	return ret;
 }
 
+static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
+		       struct mmc_data *data)
+{
+	return sdhci_issue_command(mmc, cmd, data, 0);
+}
+
+#ifdef CONFIG_MMC_ADMA
+static int sdhci_send_command_async(struct mmc *mmc, struct mmc_cmd *cmd,
+		       struct mmc_data *data)
+{
+	return sdhci_issue_command(mmc, cmd, data, 1);
+}
+#endif
+
 static int sdhci_set_clock(struct mmc *mmc, unsigned int clock)
 {
 	struct sdhci_host *host = mmc->priv;
@@ -617,6 +697,10 @@ static const struct mmc_ops sdhci_ops = {
 	.send_cmd	= sdhci_send_command,
 	.set_ios	= sdhci_set_ios,
 	.init		= sdhci_init,
+#ifdef CONFIG_MMC_ADMA
+	.send_cmd_async	= sdhci_send_command_async,
+	.data_poll	= sdhci_data_poll,
+#endif
 };
 
 int add_sdhci(struct sdhci_host *host, u32 max_clk, u32 min_clk)
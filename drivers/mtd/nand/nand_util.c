@@ -100,6 +100,7 @@ int nand_erase_opts(nand_info_t *meminfo, const nand_erase_options_t *opts)
 	     erase.addr += meminfo->erasesize) {
 
 		WATCHDOG_RESET();
+		cond_resched();
 
 		if (opts->lim && (erase.addr >= (opts->offset + opts->lim))) {
 			puts("Size of erase exceeds limit\n");
@@ -637,6 +638,7 @@ int nand_write_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
 		size_t write_size, truncated_write_size;
 
 		WATCHDOG_RESET();
+		cond_resched();
 
 		if (nand_block_isbad(nand, offset & ~(nand->erasesize - 1))) {
 			printf("Skip bad block 0x%08llx\n",
@@ -753,6 +755,7 @@ int nand_read_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
 		size_t read_length;
 
 		WATCHDOG_RESET();
+		cond_resched();
 
 		if (nand_block_isbad(nand, offset & ~(nand->erasesize - 1))) {
 			printf("Skipping bad block 0x%08llx\n",
@@ -550,17 +550,42 @@ static const unsigned int training_block_64[] = {
 #define TOTAL_NUM_PHASE	7
 #endif
 
-struct cmd_element ce_array[100]
+#define QPIC_CE_ARRAY_SIZE		100
+#define QPIC_CE_READ_ARRAY_SIZE		20
+
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+/*
+ * Descriptor FIFOs and command element lists come from an uncached
+ * pool (see qpic_bam_alloc()), so queueing them needs no cache flush.
+ */
+#define QPIC_DMA_POOL_SIZE	((QPIC_CE_ARRAY_SIZE + \
+				  QPIC_CE_READ_ARRAY_SIZE) * \
+				 sizeof(struct cmd_element) + \
+				 (QPIC_BAM_CMD_FIFO_SIZE + \
+				  QPIC_BAM_DATA_FIFO_SIZE + \
+				  QPIC_BAM_STATUS_FIFO_SIZE) * \
+				 sizeof(struct bam_desc) + \
+				 5 * ARCH_DMA_MINALIGN)
+
+static struct noncached_pool qpic_dma_pool;
+struct cmd_element *ce_array;
+struct cmd_element *ce_read_array;
+struct bam_desc *qpic_cmd_desc_fifo;
+struct bam_desc *qpic_data_desc_fifo;
+struct bam_desc *qpic_status_desc_fifo;
+#else
+struct cmd_element ce_array[QPIC_CE_ARRAY_SIZE]
 			__attribute__ ((aligned(CONFIG_SYS_CACHELINE_SIZE)));
-struct cmd_element ce_read_array[20]
+struct cmd_element ce_read_array[QPIC_CE_READ_ARRAY_SIZE]
 			__attribute__ ((aligned(CONFIG_SYS_CACHELINE_SIZE)));
-static struct qpic_nand_dev qpic_nand_dev;
 struct bam_desc qpic_cmd_desc_fifo[QPIC_BAM_CMD_FIFO_SIZE]
 			__attribute__ ((aligned(CONFIG_SYS_CACHELINE_SIZE)));
 struct bam_desc qpic_data_desc_fifo[QPIC_BAM_DATA_FIFO_SIZE]
 			__attribute__ ((aligned(CONFIG_SYS_CACHELINE_SIZE)));
 struct bam_desc qpic_status_desc_fifo[QPIC_BAM_STATUS_FIFO_SIZE]
 			__attribute__ ((aligned(CONFIG_SYS_CACHELINE_SIZE)));
+#endif
+static struct qpic_nand_dev qpic_nand_dev;
 static struct bam_instance bam;
 struct nand_ecclayout fake_ecc_layout;
 
@@ -858,11 +883,72 @@ qpic_nand_fetch_id_err:
 	return nand_ret;
 }
 
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+/*
+ * Take a buffer from the uncached pool; fall back to cached memory if it
+ * is used up. bam.c flushes anything outside the uncached region.
+ */
+static void *qpic_dma_alloc(size_t size)
+{
+	void *buf;
+
+	buf = noncached_pool_alloc(&qpic_dma_pool, size, ARCH_DMA_MINALIGN);
+	if (!buf) {
+		buf = memalign(ARCH_DMA_MINALIGN, size);
+		if (buf)
+			memset(buf, 0, size);
+	}
+
+	return buf;
+}
+
+static int qpic_bam_alloc(void)
+{
+	/* Only once: the FIFOs stay valid across re-initialisation */
+	if (qpic_cmd_desc_fifo)
+		return 0;
+
+	if (noncached_pool_init(&qpic_dma_pool, "qpic", QPIC_DMA_POOL_SIZE))
+		return -ENOMEM;
+
+	ce_array = qpic_dma_alloc(QPIC_CE_ARRAY_SIZE *
+				  sizeof(struct cmd_element));
+	ce_read_array = qpic_dma_alloc(QPIC_CE_READ_ARRAY_SIZE *
+				       sizeof(struct cmd_element));
+	qpic_data_desc_fifo = qpic_dma_alloc(QPIC_BAM_DATA_FIFO_SIZE *
+					     sizeof(struct bam_desc));
+	qpic_status_desc_fifo = qpic_dma_alloc(QPIC_BAM_STATUS_FIFO_SIZE *
+					       sizeof(struct bam_desc));
+	qpic_cmd_desc_fifo = qpic_dma_alloc(QPIC_BAM_CMD_FIFO_SIZE *
+					    sizeof(struct bam_desc));
+
+	if (!ce_array || !ce_read_array || !qpic_data_desc_fifo ||
+	    !qpic_status_desc_fifo || !qpic_cmd_desc_fifo) {
+		printf("QPIC: NANDc: BAM descriptor allocation failed\n");
+		/* Hand back what did fit, so a retry starts from scratch */
+		noncached_pool_reset(&qpic_dma_pool);
+		ce_array = NULL;
+		ce_read_array = NULL;
+		qpic_data_desc_fifo = NULL;
+		qpic_status_desc_fifo = NULL;
+		qpic_cmd_desc_fifo = NULL;
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+#endif
+
 static int
 qpic_bam_init(struct qpic_nand_init_config *config)
 {
 	uint32_t bam_ret = NANDC_RESULT_SUCCESS;
 
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	if (qpic_bam_alloc())
+		return NANDC_RESULT_FAILURE;
+#endif
+
 	bam.base = config->bam_base;
 	/* Set Read pipe params. */
 	bam.pipe[DATA_PRODUCER_PIPE_INDEX].pipe_num = config->pipes.read_pipe;
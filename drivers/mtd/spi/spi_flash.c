@@ -15,6 +15,7 @@
 #include <mapmem.h>
 #include <spi.h>
 #include <spi_flash.h>
+#include <linux/compat.h>
 #include <linux/log2.h>
 #include <linux/sizes.h>
 
@@ -429,6 +430,7 @@ int spi_flash_cmd_erase_ops(struct spi_flash *flash, u32 offset, size_t len)
 
 		offset += erase_size;
 		len -= erase_size;
+		cond_resched();
 	}
 
 	return ret;
@@ -493,6 +495,7 @@ int spi_flash_cmd_write_ops(struct spi_flash *flash, u32 offset,
 		}
 
 		offset += chunk_len;
+		cond_resched();
 	}
 
 	return ret;
@@ -587,6 +590,7 @@ int spi_flash_cmd_read_ops(struct spi_flash *flash, u32 offset,
 		offset += read_len;
 		len -= read_len;
 		data += read_len;
+		cond_resched();
 	}
 
 	free(cmd);
@@ -163,6 +163,7 @@ static struct spi_nand_flash_params spi_nand_flash_tbl[] = {
 		.nr_sectors = 1024,
 		.oob_size = 64,
 		.protec_bpx = 0x87,
+		.cont_read = 1,
 		.norm_read_cmd = winbond_norm_read_cmd,
 		.verify_ecc = verify_2bit_ecc,
 		.die_select = NULL,
@@ -180,6 +181,7 @@ static struct spi_nand_flash_params spi_nand_flash_tbl[] = {
 		.nr_sectors = 2048,
 		.oob_size = 64,
 		.protec_bpx = 0x87,
+		.cont_read = 1,
 		.norm_read_cmd = winbond_norm_read_cmd,
 		.verify_ecc = verify_2bit_ecc,
 		.die_select = spi_nand_die_select,
@@ -729,6 +731,70 @@ int verify_dummy_ecc(int status)
 	return 0;
 }
 
+/*
+ * Continuous read mode (BUF = 0 on Winbond parts): after a single page read
+ * to cache the device streams the main area of the following pages on one
+ * read command, so there is no per page command, busy wait and bus turnaround.
+ * Runs are kept within one eraseblock. The ECC status reported at the end is
+ * cumulative for the whole run.
+ */
+static int spi_nand_cont_read(struct mtd_info *mtd, int page, u8 *buf,
+			      int len)
+{
+	struct ipq40xx_spinand_info *info = mtd_to_ipq_info(mtd);
+	struct spi_flash *flash = info->flash;
+	u8 cmd[4];
+	u8 cfg, status;
+	int ret, err;
+
+	cmd[0] = IPQ40XX_SPINAND_CMD_GETFEA;
+	cmd[1] = IPQ40XX_SPINAND_FEATURE_REG;
+	ret = spi_flash_cmd_read(flash->spi, cmd, 2, &cfg, 1);
+	if (ret)
+		return ret;
+
+	cmd[0] = IPQ40XX_SPINAND_CMD_SETFEA;
+	cmd[2] = cfg & ~IPQ40XX_SPINAND_FEATURE_BUF;
+	ret = spi_flash_cmd_write(flash->spi, cmd, 3, NULL, 0);
+	if (ret)
+		return ret;
+
+	cmd[0] = IPQ40XX_SPINAND_CMD_READ;
+	cmd[1] = (u8)(page >> 16);
+	cmd[2] = (u8)(page >> 8);
+	cmd[3] = (u8)(page);
+	ret = spi_flash_cmd_write(flash->spi, cmd, 4, NULL, 0);
+	if (!ret)
+		ret = spinand_waitfunc(mtd, 0x01, &status);
+
+	if (!ret) {
+		/* No column address in this mode, just dummy bytes */
+		cmd[0] = IPQ40XX_SPINAND_CMD_NORM_READ;
+		cmd[1] = cmd[2] = cmd[3] = 0;
+		ret = spi_flash_cmd_read(flash->spi, cmd, 4, buf, len);
+		if (!ret)
+			ret = spinand_waitfunc(mtd, 0x01, &status);
+	}
+
+	/* Back to buffer mode which all the other operations rely on */
+	cmd[0] = IPQ40XX_SPINAND_CMD_SETFEA;
+	cmd[1] = IPQ40XX_SPINAND_FEATURE_REG;
+	cmd[2] = cfg;
+	err = spi_flash_cmd_write(flash->spi, cmd, 3, NULL, 0);
+	if (ret)
+		return ret;
+	if (err)
+		return err;
+
+	ret = info->params->verify_ecc(status);
+	if (ret == ECC_ERR)
+		return -EBADMSG;
+	if (ret == ECC_CORRECTED)
+		return -EUCLEAN;
+
+	return 0;
+}
+
 static int spi_nand_read_std(struct mtd_info *mtd, loff_t from, struct mtd_oob_ops *ops)
 {
 	struct ipq40xx_spinand_info *info = mtd_to_ipq_info(mtd);
@@ -739,6 +805,8 @@ static int spi_nand_read_std(struct mtd_info *mtd, loff_t from, struct mtd_oob_o
 	u8 status;
 	int realpage, page, readlen, bytes, column, bytes_oob;
 	int ecc_corrected = 0;
+	int cont = info->params->cont_read && !ops->ooblen;
+	int ppb, cret;
 	column = mtd->writesize;
 
 	realpage = (int)(from >> chip->page_shift);
@@ -758,6 +826,42 @@ static int spi_nand_read_std(struct mtd_info *mtd, loff_t from, struct mtd_oob_o
 			goto out;
 		page = fidelix_plane_select(page);
 
+		if (cont && readlen > mtd->writesize) {
+			ppb = mtd->erasesize >> chip->page_shift;
+			bytes = (ppb - (realpage % ppb)) * mtd->writesize;
+			if (bytes > readlen)
+				bytes = readlen;
+		} else {
+			bytes = 0;
+		}
+
+		if (bytes > mtd->writesize) {
+			cret = spi_nand_cont_read(mtd, page, ops->datbuf, bytes);
+			if (cret == 0 || cret == -EUCLEAN) {
+				if (cret == -EUCLEAN) {
+					mtd->ecc_stats.corrected++;
+					ecc_corrected = 1;
+				}
+				ops->retlen += bytes;
+				readlen -= bytes;
+				if (readlen <= 0)
+					break;
+				ops->datbuf += bytes;
+				realpage += bytes >> chip->page_shift;
+				page = realpage & chip->pagemask;
+				continue;
+			}
+			if (cret != -EBADMSG) {
+				ret = cret;
+				goto out;
+			}
+			/*
+			 * The status does not say which page of the run is
+			 * bad, locate it with page by page reads.
+			 */
+			cont = 0;
+		}
+
 		cmd[0] = IPQ40XX_SPINAND_CMD_READ;
 		cmd[1] = (u8)(page >> 16);
 		cmd[2] = (u8)(page >> 8);
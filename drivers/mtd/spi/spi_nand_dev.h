@@ -50,6 +50,7 @@
 #define IPQ40XX_SPINAND_FEATURE_OTPPRT			0x80
 #define IPQ40XX_SPINAND_FEATURE_OPTEN			0x40
 #define IPQ40XX_SPINAND_FEATURE_ECC_EN			0x10
+#define IPQ40XX_SPINAND_FEATURE_BUF			0x08
 #define IPQ40XX_SPINAND_FEATURE_QE			0x01
 
 /* Flash status register. */
@@ -82,6 +83,7 @@ struct spi_nand_flash_params {
 	int prev_die_id;
 	u8 plane_id;
 	u8 protec_bpx;
+	u8 cont_read;
 	u64 pages_per_die;
 	void (*norm_read_cmd) (u8 *cmd, int column);
 	int (*verify_ecc) (int status);
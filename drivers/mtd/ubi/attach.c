@@ -90,6 +90,8 @@ static int self_check_ai(struct ubi_device *ubi, struct ubi_attach_info *ai);
 /* Temporary variables used during scanning */
 static struct ubi_ec_hdr *ech;
 static struct ubi_vid_hdr *vidh;
+/* Buffer for reading both headers at once, see 'ubi_io_read_hdrs()' */
+static void *hdrs_buf;
 
 /**
  * add_to_list - add physical eraseblock to a list.
@@ -816,7 +818,7 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		    int pnum, int *vid, unsigned long long *sqnum)
 {
 	long long uninitialized_var(ec);
-	int err, bitflips = 0, vol_id = -1, ec_err = 0;
+	int err, bitflips = 0, vol_id = -1, ec_err = 0, vid_err = 0;
 
 	dbg_bld("scan PEB %d", pnum);
 
@@ -829,7 +831,11 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		return 0;
 	}
 
-	err = ubi_io_read_ec_hdr(ubi, pnum, ech, 0);
+	if (hdrs_buf)
+		err = ubi_io_read_hdrs(ubi, pnum, hdrs_buf, ech, vidh,
+				       &vid_err, 0);
+	else
+		err = ubi_io_read_ec_hdr(ubi, pnum, ech, 0);
 	if (err < 0)
 		return err;
 	switch (err) {
@@ -912,7 +918,10 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 
 	/* OK, we've done with the EC header, let's look at the VID header */
 
-	err = ubi_io_read_vid_hdr(ubi, pnum, vidh, 0);
+	if (hdrs_buf)
+		err = vid_err;
+	else
+		err = ubi_io_read_vid_hdr(ubi, pnum, vidh, 0);
 	if (err < 0)
 		return err;
 	switch (err) {
@@ -1239,6 +1248,10 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (!vidh)
 		goto out_ech;
 
+	/* Not fatal, we just fall back to reading the headers one by one */
+	hdrs_buf = kmalloc(ubi->vid_hdr_aloffset + ubi->vid_hdr_alsize,
+			   GFP_KERNEL);
+
 	for (pnum = start; pnum < ubi->peb_count; pnum++) {
 		cond_resched();
 
@@ -1285,12 +1298,16 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (err)
 		goto out_vidh;
 
+	kfree(hdrs_buf);
+	hdrs_buf = NULL;
 	ubi_free_vid_hdr(ubi, vidh);
 	kfree(ech);
 
 	return 0;
 
 out_vidh:
+	kfree(hdrs_buf);
+	hdrs_buf = NULL;
 	ubi_free_vid_hdr(ubi, vidh);
 out_ech:
 	kfree(ech);
@@ -1348,6 +1365,9 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 	if (!vidh)
 		goto out_ech;
 
+	hdrs_buf = kmalloc(ubi->vid_hdr_aloffset + ubi->vid_hdr_alsize,
+			   GFP_KERNEL);
+
 	for (pnum = 0; pnum < UBI_FM_MAX_START; pnum++) {
 		int vol_id = -1;
 		unsigned long long sqnum = -1;
@@ -1364,6 +1384,8 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 		}
 	}
 
+	kfree(hdrs_buf);
+	hdrs_buf = NULL;
 	ubi_free_vid_hdr(ubi, vidh);
 	kfree(ech);
 
@@ -1378,6 +1400,8 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 	return ubi_scan_fastmap(ubi, *ai, fm_anchor);
 
 out_vidh:
+	kfree(hdrs_buf);
+	hdrs_buf = NULL;
 	ubi_free_vid_hdr(ubi, vidh);
 out_ech:
 	kfree(ech);
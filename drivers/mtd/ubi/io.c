@@ -92,6 +92,12 @@ static int self_check_vid_hdr(const struct ubi_device *ubi, int pnum,
 			      const struct ubi_vid_hdr *vid_hdr);
 static int self_check_write(struct ubi_device *ubi, const void *buf, int pnum,
 			    int offset, int len);
+static int check_ec_hdr(const struct ubi_device *ubi, int pnum,
+			const struct ubi_ec_hdr *ec_hdr, int read_err,
+			int verbose);
+static int check_vid_hdr(const struct ubi_device *ubi, int pnum,
+			 const struct ubi_vid_hdr *vid_hdr, int read_err,
+			 int verbose);
 
 /**
  * ubi_io_read - read data from a physical eraseblock.
@@ -724,8 +730,7 @@ bad:
 int ubi_io_read_ec_hdr(struct ubi_device *ubi, int pnum,
 		       struct ubi_ec_hdr *ec_hdr, int verbose)
 {
-	int err, read_err;
-	uint32_t crc, magic, hdr_crc;
+	int read_err;
 
 	dbg_io("read EC header from PEB %d", pnum);
 	ubi_assert(pnum >= 0 && pnum < ubi->peb_count);
@@ -746,6 +751,27 @@ int ubi_io_read_ec_hdr(struct ubi_device *ubi, int pnum,
 		 */
 	}
 
+	return check_ec_hdr(ubi, pnum, ec_hdr, read_err, verbose);
+}
+
+/**
+ * check_ec_hdr - check an erase counter header which was read from the media.
+ * @ubi: UBI device description object
+ * @pnum: physical eraseblock the header was read from
+ * @ec_hdr: the erase counter header to check
+ * @read_err: what the read of @ec_hdr returned
+ * @verbose: be verbose if the header is corrupted or was not found
+ *
+ * This is a helper for 'ubi_io_read_ec_hdr()' and 'ubi_io_read_hdrs()' and
+ * returns the same codes as 'ubi_io_read_ec_hdr()'.
+ */
+static int check_ec_hdr(const struct ubi_device *ubi, int pnum,
+			const struct ubi_ec_hdr *ec_hdr, int read_err,
+			int verbose)
+{
+	int err;
+	uint32_t crc, magic, hdr_crc;
+
 	magic = be32_to_cpu(ec_hdr->magic);
 	if (magic != UBI_EC_HDR_MAGIC) {
 		if (mtd_is_eccerr(read_err))
@@ -997,8 +1023,7 @@ bad:
 int ubi_io_read_vid_hdr(struct ubi_device *ubi, int pnum,
 			struct ubi_vid_hdr *vid_hdr, int verbose)
 {
-	int err, read_err;
-	uint32_t crc, magic, hdr_crc;
+	int read_err;
 	void *p;
 
 	dbg_io("read VID header from PEB %d", pnum);
@@ -1010,6 +1035,27 @@ int ubi_io_read_vid_hdr(struct ubi_device *ubi, int pnum,
 	if (read_err && read_err != UBI_IO_BITFLIPS && !mtd_is_eccerr(read_err))
 		return read_err;
 
+	return check_vid_hdr(ubi, pnum, vid_hdr, read_err, verbose);
+}
+
+/**
+ * check_vid_hdr - check a volume identifier header read from the media.
+ * @ubi: UBI device description object
+ * @pnum: physical eraseblock the header was read from
+ * @vid_hdr: the volume identifier header to check
+ * @read_err: what the read of @vid_hdr returned
+ * @verbose: be verbose if the header is corrupted or wasn't found
+ *
+ * This is a helper for 'ubi_io_read_vid_hdr()' and 'ubi_io_read_hdrs()' and
+ * returns the same codes as 'ubi_io_read_vid_hdr()'.
+ */
+static int check_vid_hdr(const struct ubi_device *ubi, int pnum,
+			 const struct ubi_vid_hdr *vid_hdr, int read_err,
+			 int verbose)
+{
+	int err;
+	uint32_t crc, magic, hdr_crc;
+
 	magic = be32_to_cpu(vid_hdr->magic);
 	if (magic != UBI_VID_HDR_MAGIC) {
 		if (mtd_is_eccerr(read_err))
@@ -1063,6 +1109,72 @@ int ubi_io_read_vid_hdr(struct ubi_device *ubi, int pnum,
 	return read_err ? UBI_IO_BITFLIPS : 0;
 }
 
+/**
+ * ubi_io_read_hdrs - read and check both the EC and the VID header of a PEB.
+ * @ubi: UBI device description object
+ * @pnum: physical eraseblock number to read from
+ * @buf: scratch buffer of @ubi->vid_hdr_aloffset + @ubi->vid_hdr_alsize bytes
+ * @ec_hdr: &struct ubi_ec_hdr object where to store the erase counter header
+ * @vid_hdr: &struct ubi_vid_hdr object where to store the VID header
+ * @vid_err: the status of the VID header is returned here
+ * @verbose: be verbose if a header is corrupted or was not found
+ *
+ * Both headers live at the very beginning of the PEB, so instead of issuing
+ * two small reads (two NAND page reads with their command and ECC overhead)
+ * this function fetches the whole head of the PEB with one multi-page read
+ * and checks the headers in place. This is what makes full scanning on big
+ * NAND chips bearable.
+ *
+ * The combined read cannot tell which header a bit-flip or an ECC error
+ * belongs to, so in any of these cases the headers are re-read one by one
+ * the usual way.
+ *
+ * Returns the EC header status exactly like 'ubi_io_read_ec_hdr()' does.
+ * @vid_err is only valid if the EC header status is neither negative nor
+ * %UBI_IO_FF/%UBI_IO_FF_BITFLIPS, and then holds what
+ * 'ubi_io_read_vid_hdr()' would have returned.
+ */
+int ubi_io_read_hdrs(struct ubi_device *ubi, int pnum, void *buf,
+		     struct ubi_ec_hdr *ec_hdr, struct ubi_vid_hdr *vid_hdr,
+		     int *vid_err, int verbose)
+{
+	int err, len = ubi->vid_hdr_aloffset + ubi->vid_hdr_alsize;
+	size_t read;
+	loff_t addr;
+
+	dbg_io("read EC and VID headers from PEB %d", pnum);
+	ubi_assert(pnum >= 0 && pnum < ubi->peb_count);
+
+	err = self_check_not_bad(ubi, pnum);
+	if (err)
+		return err;
+
+	/* See 'ubi_io_read()' for why the buffer is corrupted first */
+	*((uint8_t *)buf) ^= 0xFF;
+	*((uint8_t *)buf + ubi->vid_hdr_offset) ^= 0xFF;
+
+	addr = (loff_t)pnum * ubi->peb_size;
+	err = mtd_read(ubi->mtd, addr, len, &read, buf);
+	if (err || read != len || ubi_dbg_is_bitflip(ubi)) {
+		dbg_io("combined header read of PEB %d returned %d, re-read",
+		       pnum, err);
+		err = ubi_io_read_ec_hdr(ubi, pnum, ec_hdr, verbose);
+		if (err < 0 || err == UBI_IO_FF || err == UBI_IO_FF_BITFLIPS)
+			return err;
+		*vid_err = ubi_io_read_vid_hdr(ubi, pnum, vid_hdr, verbose);
+		return err;
+	}
+
+	memcpy(ec_hdr, buf, UBI_EC_HDR_SIZE);
+	err = check_ec_hdr(ubi, pnum, ec_hdr, 0, verbose);
+	if (err < 0 || err == UBI_IO_FF || err == UBI_IO_FF_BITFLIPS)
+		return err;
+
+	memcpy(vid_hdr, (char *)buf + ubi->vid_hdr_offset, UBI_VID_HDR_SIZE);
+	*vid_err = check_vid_hdr(ubi, pnum, vid_hdr, 0, verbose);
+	return err;
+}
+
 /**
  * ubi_io_write_vid_hdr - write a volume identifier header.
  * @ubi: UBI device description object
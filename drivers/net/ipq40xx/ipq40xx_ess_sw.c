@@ -15,6 +15,9 @@
 #include <net.h>
 #include <asm-generic/errno.h>
 #include <asm/io.h>
+#ifdef CONFIG_IPQ_LAZY_INIT
+#include <asm/arch-qca-common/qca_common.h>
+#endif
 
 #include "ipq40xx_ess_sw.h"
 #include "ipq40xx.h"
@@ -230,6 +233,11 @@ static int ipq40xx_ess_stats(cmd_tbl_t *cmdtp, int flag,
 
 	if (portno > 6)
 	        return CMD_RET_USAGE;
+
+#ifdef CONFIG_IPQ_LAZY_INIT
+	/* The switch is only clocked once net is up */
+	ipq_lazy_init(IPQ_LAZY_NET);
+#endif
 	/*
 	 * Tx stats
 	 */
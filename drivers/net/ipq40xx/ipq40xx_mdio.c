@@ -16,6 +16,9 @@
 #include <phy.h>
 #include <asm/io.h>
 #include <errno.h>
+#ifdef CONFIG_IPQ_LAZY_INIT
+#include <asm/arch-qca-common/qca_common.h>
+#endif
 #include "ipq40xx_mdio.h"
 
 struct ipq40xx_mdio_data {
@@ -23,6 +26,14 @@ struct ipq40xx_mdio_data {
 	int phy_irq[PHY_MAX_ADDR];
 };
 
+/* Debug commands can reach the bus before anything has brought up net */
+static inline void ipq40xx_mdio_lazy_init(void)
+{
+#ifdef CONFIG_IPQ_LAZY_INIT
+	ipq_lazy_init(IPQ_LAZY_NET);
+#endif
+}
+
 static int ipq40xx_mdio_wait_busy(void)
 {
 	int i;
@@ -44,6 +55,7 @@ static int ipq40xx_mdio_wait_busy(void)
 
 int ipq40xx_mdio_write(int mii_id, int regnum, u16 value)
 {
+	ipq40xx_mdio_lazy_init();
 	if (ipq40xx_mdio_wait_busy())
 		return -ETIMEDOUT;
 	/* Issue the phy addreass and reg */
@@ -69,6 +81,8 @@ int ipq40xx_mdio_write(int mii_id, int regnum, u16 value)
 int ipq40xx_mdio_read(int mii_id, int regnum, ushort *data)
 {
 	u32 val;
+
+	ipq40xx_mdio_lazy_init();
 	if (ipq40xx_mdio_wait_busy())
 		return -ETIMEDOUT;
 
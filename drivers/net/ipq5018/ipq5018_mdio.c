@@ -17,6 +17,9 @@
 #include <phy.h>
 #include <asm/io.h>
 #include <errno.h>
+#ifdef CONFIG_IPQ_LAZY_INIT
+#include <asm/arch-qca-common/qca_common.h>
+#endif
 #include "ipq5018_mdio.h"
 
 struct ipq5018_mdio_data {
@@ -24,6 +27,14 @@ struct ipq5018_mdio_data {
 	int phy_irq[PHY_MAX_ADDR];
 };
 
+/* Debug commands can reach the bus before anything has brought up net */
+static inline void ipq5018_mdio_lazy_init(void)
+{
+#ifdef CONFIG_IPQ_LAZY_INIT
+	ipq_lazy_init(IPQ_LAZY_NET);
+#endif
+}
+
 static int ipq5018_mdio_wait_busy(void)
 {
 	int i;
@@ -46,6 +57,8 @@ static int ipq5018_mdio_wait_busy(void)
 int ipq5018_mdio_write(int mii_id, int regnum, u16 value)
 {
 	u32 cmd;
+
+	ipq5018_mdio_lazy_init();
 	if (ipq5018_mdio_wait_busy())
 		return -ETIMEDOUT;
 
@@ -100,6 +113,8 @@ int ipq5018_mdio_write(int mii_id, int regnum, u16 value)
 int ipq5018_mdio_read(int mii_id, int regnum, ushort *data)
 {
 	u32 val,cmd;
+
+	ipq5018_mdio_lazy_init();
 	if (ipq5018_mdio_wait_busy())
 		return -ETIMEDOUT;
 
@@ -77,7 +77,8 @@ extern void ipq5332_qca8075_phy_interface_set_mode(uint32_t phy_id,
 extern int ipq_qca8033_phy_init(struct phy_ops **ops, u32 phy_id);
 extern int ipq_qca8081_phy_init(struct phy_ops **ops, u32 phy_id);
 extern int ipq_qca_aquantia_phy_init(struct phy_ops **ops, u32 phy_id);
-extern int ipq_board_fw_download(unsigned int phy_addr);
+extern int ipq_board_fw_download_start(unsigned int phy_addr);
+extern int ipq_board_fw_download_finish(void);
 extern int ipq_qca8084_hw_init(phy_info_t * phy_info[]);
 extern int ipq_qca8084_link_update(phy_info_t * phy_info[]);
 extern void ipq_qca8084_switch_hw_reset(int gpio);
@@ -1859,6 +1860,9 @@ int ipq5332_edma_init(void *edma_board_cfg)
 	int qca8084_swt_enb = 0;
 #endif
 	int qca8084_chip_detect = 0;
+#ifdef CONFIG_IPQ_QCA_AQUANTIA_PHY
+	u32 aq_ports = 0;
+#endif
 
 #ifdef CONFIG_IPQ5332_QCA8075_PHY
 	static int sw_init_done = 0;
@@ -1867,13 +1871,6 @@ int ipq5332_edma_init(void *edma_board_cfg)
 	int s17c_swt_enb = 0;
 #endif
 	int node, phy_addr, mode, phy_node = -1;
-	/*
-	 * Init non cache buffer
-	 */
-#ifdef CONFIG_SYS_NONCACHED_MEMORY
-	noncached_init();
-#endif
-
 	node = fdt_path_offset(gd->fdt_blob, "/ess-switch");
 #ifdef CONFIG_QCA8084_SWT_MODE
 #ifdef CONFIG_QCA8084_BYPASS_MODE
@@ -2144,11 +2141,8 @@ int ipq5332_edma_init(void *edma_board_cfg)
 			case AQUANTIA_PHY_113C_A1:
 			case AQUANTIA_PHY_113C_B0:
 			case AQUANTIA_PHY_113C_B1:
-				ipq_board_fw_download(phy_addr);
-				mdelay(100);
-				ipq_qca_aquantia_phy_init(
-					&ipq5332_edma_dev[i]->ops[phy_id],
-					phy_addr);
+				ipq_board_fw_download_start(phy_addr);
+				aq_ports |= 1 << phy_id;
 			break;
 #endif
 			default:
@@ -2162,6 +2156,25 @@ int ipq5332_edma_init(void *edma_board_cfg)
 			}
 		}
 
+#ifdef CONFIG_IPQ_QCA_AQUANTIA_PHY
+		/*
+		 * Start the Aquantia firmware on all ports at once; the ops
+		 * talk to the running firmware, so map them afterwards.
+		 */
+		ipq_board_fw_download_finish();
+		if (aq_ports)
+			mdelay(100);
+		for (phy_id = 0; phy_id < IPQ5332_PHY_MAX; phy_id++) {
+			if (!(aq_ports & (1 << phy_id)))
+				continue;
+			ipq_set_mdio_mode(mdio_info[phy_id]->mode,
+						mdio_info[phy_id]->bus_no);
+			ipq_qca_aquantia_phy_init(
+				&ipq5332_edma_dev[i]->ops[phy_id],
+				port_info[phy_id]->phy_info->phy_address);
+		}
+#endif
+
 		for (phy_id = 0; phy_id < qca8084_chip_detect; ++phy_id) {
 
 			ipq_set_mdio_mode(mdio_info[phy_id]->mode,
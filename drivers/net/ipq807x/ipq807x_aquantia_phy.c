@@ -62,6 +62,37 @@ static int program_ethphy_fw(unsigned int phy_addr,
 			 uint32_t load_addr,uint32_t file_size );
 static qca_smem_flash_info_t *sfi = &qca_smem_flash_info;
 
+extern void ipq_set_mdio_mode(const int mode, const int bus);
+extern void ipq_get_mdio_mode(int *mode, int *bus);
+
+#define AQ_FW_MAX_PHYS		6
+#define AQ_FW_RESET_MS		100
+#define AQ_FW_ID_REG		0x20	/* running firmware major.minor */
+#define AQ_FW_TAG_CRC_REG	0x300	/* scratch pad: CRC of the loaded image */
+#define AQ_FW_TAG_ID_REG	0x301	/* scratch pad: firmware ID it booted as */
+
+/*
+ * Firmware download is split in two: each PHY is loaded and left with
+ * its processor in reset, then all of them are released together so the
+ * reset and boot waits are paid once per bring-up rather than per PHY.
+ * The image checks are likewise done once for all the PHYs it goes to.
+ */
+static struct {
+	unsigned int *image;	/* ETHPHYFW partition, read once */
+	int verified;		/* file CRC checked, load_crc valid */
+	uint16_t file_crc;	/* trailing CRC-16 of the image */
+	uint16_t load_crc;	/* CRC-16 the mailbox reports after a load */
+	int count;
+	struct {
+		unsigned int phy_addr;
+		int mdio_mode;
+		int mdio_bus;
+	} phy[AQ_FW_MAX_PHYS];
+	ulong reset_start;	/* get_timer() when the last PHY was held */
+} aq_fw;
+
+int ipq_board_fw_download_finish(void);
+
 u16 aq_phy_reg_write(u32 dev_id, u32 phy_id,
 		u32 reg_id, u16 reg_val)
 {
@@ -215,7 +246,11 @@ static int do_aq_phy_restart(cmd_tbl_t *cmdtp, int flag, int argc, char * const
 	return 0;
 }
 
-int ipq_board_fw_download(unsigned int phy_addr)
+/*
+ * Load the firmware into one PHY and hold its processor in reset. The
+ * PHY only starts once ipq_board_fw_download_finish() is called.
+ */
+int ipq_board_fw_download_start(unsigned int phy_addr)
 {
 	char runcmd[256];
 	int ret,i=0;
@@ -230,6 +265,14 @@ int ipq_board_fw_download(unsigned int phy_addr)
 	block_dev_desc_t *blk_dev;
 	disk_partition_t disk_info;
 #endif
+	if (aq_fw.count == AQ_FW_MAX_PHYS)
+		ipq_board_fw_download_finish();
+
+	if (aq_fw.image) {
+		ethphyfw_load_addr = aq_fw.image;
+		goto program;
+	}
+
 	/* check the smem info to see which flash used for booting */
 	if (sfi->flash_type == SMEM_BOOT_SPI_FLASH) {
 		if (debug) {
@@ -325,11 +368,13 @@ int ipq_board_fw_download(unsigned int phy_addr)
 #endif
 	}
 
+program:
 	fwimg_header = (mbn_header_t *)(ethphyfw_load_addr);
 
 	if (fwimg_header->image_type == 0x13 &&
 	    fwimg_header->header_vsn_num == 0x3) {
-		program_ethphy_fw(phy_addr,
+		aq_fw.image = ethphyfw_load_addr;
+		return program_ethphy_fw(phy_addr,
 				  (uint32_t)(((uint32_t)ethphyfw_load_addr)
 					     + sizeof(mbn_header_t)),
 				  (uint32_t)(fwimg_header->image_size));
@@ -338,15 +383,144 @@ int ipq_board_fw_download(unsigned int phy_addr)
 		free(ethphyfw_load_addr);
 		return -1;
 	}
-	free(ethphyfw_load_addr);
+}
+
+/*
+ * Release every PHY loaded by ipq_board_fw_download_start() and restart
+ * autonegotiation on them. The MDIO mode each PHY was loaded with is put
+ * back while talking to it and restored afterwards.
+ */
+int ipq_board_fw_download_finish(void)
+{
+	int mode, bus, i;
+	uint16_t fw_id;
+	ulong elapsed;
+
+	if (!aq_fw.count)
+		goto out;
+
+	ipq_get_mdio_mode(&mode, &bus);
+
+	elapsed = get_timer(aq_fw.reset_start);
+	if (elapsed < AQ_FW_RESET_MS)
+		mdelay(AQ_FW_RESET_MS - elapsed);
+	for (i = 0; i < aq_fw.count; i++) {
+		ipq_set_mdio_mode(aq_fw.phy[i].mdio_mode, aq_fw.phy[i].mdio_bus);
+		aq_phy_reg_write(0x0, aq_fw.phy[i].phy_addr,
+				 AQUANTIA_REG_ADDRESS(0x1e, 0xc001), 0x40);
+	}
+	mdelay(AQ_FW_RESET_MS);
+	for (i = 0; i < aq_fw.count; i++) {
+		ipq_set_mdio_mode(aq_fw.phy[i].mdio_mode, aq_fw.phy[i].mdio_bus);
+		aquantia_phy_restart_autoneg(aq_fw.phy[i].phy_addr);
+		/* Lets a later bring-up find this image already running */
+		fw_id = aq_phy_reg_read(0x0, aq_fw.phy[i].phy_addr,
+					AQUANTIA_REG_ADDRESS(0x1e, AQ_FW_ID_REG));
+		aq_phy_reg_write(0x0, aq_fw.phy[i].phy_addr,
+				 AQUANTIA_REG_ADDRESS(0x1e, AQ_FW_TAG_CRC_REG),
+				 aq_fw.file_crc);
+		aq_phy_reg_write(0x0, aq_fw.phy[i].phy_addr,
+				 AQUANTIA_REG_ADDRESS(0x1e, AQ_FW_TAG_ID_REG),
+				 fw_id);
+	}
+
+	ipq_set_mdio_mode(mode, bus);
+	aq_fw.count = 0;
+out:
+	free(aq_fw.image);
+	aq_fw.image = NULL;
+	aq_fw.verified = 0;
 	return 0;
 }
 
+int ipq_board_fw_download(unsigned int phy_addr)
+{
+	int ret;
+
+	ret = ipq_board_fw_download_start(phy_addr);
+	ipq_board_fw_download_finish();
+	return ret;
+}
+
+
+/*
+ * Fetch the dword at @data, zero padding a partial last dword the same
+ * way the mailbox expects it.
+ */
+static void aq_fw_get_dword(uint8_t *dword, const uint8_t *data, uint32_t left)
+{
+	memset(dword, 0, 4);
+	memcpy(dword, data, left < 4 ? left : 4);
+}
+
+/*
+ * CRC-16 the mailbox accumulates over a segment: each dword is fed most
+ * significant byte first. Only depends on the image, so it is computed
+ * once per image rather than while writing every PHY.
+ */
+static uint16_t aq_fw_segment_crc(const uint8_t *data, uint32_t size,
+				  uint16_t crc)
+{
+	uint8_t dword[4], be[4];
+	uint32_t off;
+
+	for (off = 0; off < size; off += 4) {
+		aq_fw_get_dword(dword, data + off, size - off);
+		be[0] = dword[3];
+		be[1] = dword[2];
+		be[2] = dword[1];
+		be[3] = dword[0];
+		crc = cyg_crc16_computed(be, 4, crc);
+	}
+	return crc;
+}
+
+/*
+ * Write a segment to PHY memory at @base through the mailbox, one dword
+ * (msw, lsw, write command) at a time.
+ */
+static void aq_fw_load_segment(unsigned int phy_addr, uint16_t base,
+			       const uint8_t *data, uint32_t size)
+{
+	uint8_t dword[4];
+	uint32_t off;
+
+	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x202), base);
+	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x203), 0x0);
+	for (off = 0; off < size; off += 4) {
+		aq_fw_get_dword(dword, data + off, size - off);
+		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x204),
+				 (dword[3] << 8) | dword[2]);
+		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x205),
+				 (dword[1] << 8) | dword[0]);
+		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x200),
+				 0xc000);
+	}
+}
+
+/*
+ * A PHY left running by an earlier download and not reset since carries
+ * the image CRC and the firmware ID it booted as in its scratch pad, see
+ * ipq_board_fw_download_finish().
+ */
+static int aq_fw_is_running(unsigned int phy_addr, uint16_t file_crc)
+{
+	uint16_t fw_id;
+
+	fw_id = aq_phy_reg_read(0x0, phy_addr,
+				AQUANTIA_REG_ADDRESS(0x1e, AQ_FW_ID_REG));
+	if (!fw_id || fw_id == 0xffff)
+		return 0;
+
+	return aq_phy_reg_read(0x0, phy_addr,
+			AQUANTIA_REG_ADDRESS(0x1e, AQ_FW_TAG_CRC_REG)) == file_crc &&
+	       aq_phy_reg_read(0x0, phy_addr,
+			AQUANTIA_REG_ADDRESS(0x1e, AQ_FW_TAG_ID_REG)) == fw_id;
+}
 
 #define AQ_PHY_IMAGE_HEADER_CONTENT_OFFSET_HHD 0x300
 static int program_ethphy_fw(unsigned int phy_addr, uint32_t load_addr, uint32_t file_size)
 {
-	int i;
 	uint8_t *buf;
 	uint16_t file_crc;
 	uint16_t computed_crc;
@@ -359,17 +533,16 @@ static int program_ethphy_fw(unsigned int phy_addr, uint32_t load_addr, uint32_t
 	uint32_t primary_iram_sz = 0x00000000;
 	uint32_t primary_dram_sz = 0x00000000;
 	uint32_t phy_img_hdr_off;
-	uint32_t byte_sz;
-	uint32_t dword_sz;
-	uint32_t byte_ptr;
-	uint16_t msw = 0;
-	uint16_t lsw = 0;
-	uint8_t msb1;
-	uint8_t msb2;
-	uint8_t lsb1;
-	uint8_t lsb2;
 	uint16_t mailbox_crc;
 
+	buf = (uint8_t *)load_addr;
+	file_crc = buf[file_size - 2] << 8 | buf[file_size - 1];
+	if (aq_fw_is_running(phy_addr, file_crc)) {
+		printf("PHY %d: fw image (0x%04X) already running, skipping load\n",
+		       phy_addr, file_crc);
+		return 0;
+	}
+
 	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x300), 0xdead);
 	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x301), 0xbeaf);
 	reg1 = aq_phy_reg_read(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x300));
@@ -377,17 +550,17 @@ static int program_ethphy_fw(unsigned int phy_addr, uint32_t load_addr, uint32_t
 
 	if(reg1 != 0xdead && reg2 != 0xbeaf) {
 		printf("PHY::Scratchpad Read/Write test fail\n");
-		return 0;
+		return -1;
 	}
-	buf = (uint8_t *)load_addr;
-	file_crc = buf[file_size - 2] << 8 | buf[file_size - 1];
-	computed_crc = cyg_crc16(buf, file_size - 2);
 
-	if (file_crc != computed_crc) {
-		printf("CRC check failed on phy fw file\n");
-		return 0;
-	} else {
-		printf ("CRC check good on phy fw file (0x%04X)\n",computed_crc);
+	if (!aq_fw.verified) {
+		computed_crc = cyg_crc16(buf, file_size - 2);
+		if (file_crc != computed_crc) {
+			printf("CRC check failed on phy fw file\n");
+			return -1;
+		} else {
+			printf("CRC check good on phy fw file (0x%04X)\n",computed_crc);
+		}
 	}
 
 	daisy_chain_dis = aq_phy_reg_read(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0xc452));
@@ -417,134 +590,45 @@ static int program_ethphy_fw(unsigned int phy_addr, uint32_t load_addr, uint32_t
 	primary_iram_ptr += primary_header_ptr;
 	primary_dram_ptr += primary_header_ptr;
 
+	if (!aq_fw.verified) {
+		aq_fw.file_crc = file_crc;
+		aq_fw.load_crc = aq_fw_segment_crc(buf + primary_iram_ptr,
+						   primary_iram_sz, 0);
+		aq_fw.load_crc = aq_fw_segment_crc(buf + primary_dram_ptr,
+						   primary_dram_sz,
+						   aq_fw.load_crc);
+		aq_fw.verified = 1;
+	}
+	computed_crc = aq_fw.load_crc;
+
 	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x200), 0x1000);
 	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x200), 0x0);
-	computed_crc = 0;
 	printf("PHYFW:Loading IRAM...........");
-	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x202), 0x4000);
-	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x203), 0x0);
-	byte_sz = primary_iram_sz;
-	dword_sz = byte_sz >> 2;
-	byte_ptr = primary_iram_ptr;
-	for (i = 0; i < dword_sz; i++) {
-		lsw = (buf[byte_ptr + 1] << 8) | buf[byte_ptr];
-		byte_ptr += 2;
-		msw = (buf[byte_ptr + 1] << 8) | buf[byte_ptr];
-		byte_ptr += 2;
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x204), msw);
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x205), lsw);
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x200), 0xc000);
-		msb1 = msw >> 8;
-		msb2 = msw & 0xFF;
-		lsb1 = lsw >> 8;
-		lsb2 = lsw & 0xFF;
-		computed_crc = cyg_crc16_computed(&msb1, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&msb2, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&lsb1, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&lsb2, 0x1, computed_crc);
-	}
-
-	switch (byte_sz & 0x3) {
-	case 0x1:
-		lsw = buf[byte_ptr++];
-		msw = 0x0000;
-		break;
-	case 0x2:
-		lsw = (buf[byte_ptr + 1] << 8) | buf[byte_ptr];
-		byte_ptr += 2;
-		msw = 0x0000;
-		break;
-	case 0x3:
-		lsw = (buf[byte_ptr + 1] << 8) | buf[byte_ptr];
-		byte_ptr += 2;
-		msw = buf[byte_ptr++];
-		break;
-	}
-
-	if (byte_sz & 0x3) {
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x204), msw);
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x205), lsw);
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x200), 0xc000);
-		msb1 = msw >> 8;
-		msb2 = msw & 0xFF;
-		lsb1 = lsw >> 8;
-		lsb2 = lsw & 0xFF;
-		computed_crc = cyg_crc16_computed(&msb1, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&msb2, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&lsb1, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&lsb2, 0x1, computed_crc);
-	}
+	aq_fw_load_segment(phy_addr, 0x4000, buf + primary_iram_ptr,
+			   primary_iram_sz);
 	printf("done.\n");
 	printf("PHYFW:Loading DRAM..............");
-	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x202), 0x3ffe);
-	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x203), 0x0);
-	byte_sz = primary_dram_sz;
-	dword_sz = byte_sz >> 2;
-	byte_ptr = primary_dram_ptr;
-	for (i = 0; i < dword_sz; i++) {
-		lsw = (buf[byte_ptr + 1] << 8) | buf[byte_ptr];
-		byte_ptr += 2;
-		msw = (buf[byte_ptr + 1] << 8) | buf[byte_ptr];
-		byte_ptr += 2;
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x204), msw);
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x205), lsw);
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x200), 0xc000);
-		msb1 = msw >> 8;
-		msb2 = msw & 0xFF;
-		lsb1 = lsw >> 8;
-		lsb2 = lsw & 0xFF;
-		computed_crc = cyg_crc16_computed(&msb1, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&msb2, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&lsb1, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&lsb2, 0x1, computed_crc);
-	}
-
-	switch (byte_sz & 0x3) {
-	case 0x1:
-		lsw = buf[byte_ptr++];
-		msw = 0x0000;
-		break;
-	case 0x2:
-		lsw = (buf[byte_ptr + 1] << 8) | buf[byte_ptr];
-		byte_ptr += 2;
-		msw = 0x0000;
-		break;
-	case 0x3:
-		lsw = (buf[byte_ptr + 1] << 8) | buf[byte_ptr];
-		byte_ptr += 2;
-		msw = buf[byte_ptr++];
-		break;
-	}
-
-	if (byte_sz & 0x3) {
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x204), msw);
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x205), lsw);
-		aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x200), 0xc000);
-		msb1 = msw >> 8;
-		msb2 = msw & 0xFF;
-		lsb1 = lsw >> 8;
-		lsb2 = lsw & 0xFF;
-		computed_crc = cyg_crc16_computed(&msb1, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&msb2, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&lsb1, 0x1, computed_crc);
-		computed_crc = cyg_crc16_computed(&lsb2, 0x1, computed_crc);
-	}
+	aq_fw_load_segment(phy_addr, 0x3ffe, buf + primary_dram_ptr,
+			   primary_dram_sz);
 	printf("done.\n");
 	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0xc441), 0x2010);
 	mailbox_crc = aq_phy_reg_read(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x201));
 	if (mailbox_crc != computed_crc) {
 		printf("phy fw image load  CRC-16 (0x%X) does not match calculated CRC-16 (0x%X)\n", mailbox_crc, computed_crc);
-		return 0;
+		return -1;
 	} else
 		printf("phy fw image load good CRC-16 matches (0x%X)\n", mailbox_crc);
 
 	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0x0), 0x0);
 	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0xc001), 0x41);
 	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0xc001), 0x8041);
-	mdelay(100);
-	aq_phy_reg_write(0x0, phy_addr, AQUANTIA_REG_ADDRESS(0x1e, 0xc001), 0x40);
-	mdelay(100);
-	aquantia_phy_restart_autoneg(phy_addr);
+
+	/* Released from reset by ipq_board_fw_download_finish() */
+	aq_fw.phy[aq_fw.count].phy_addr = phy_addr;
+	ipq_get_mdio_mode(&aq_fw.phy[aq_fw.count].mdio_mode,
+			  &aq_fw.phy[aq_fw.count].mdio_bus);
+	aq_fw.count++;
+	aq_fw.reset_start = get_timer(0);
 	return 0;
 }
 
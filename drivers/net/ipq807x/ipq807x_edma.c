@@ -62,7 +62,8 @@ extern void qca8075_phy_interface_set_mode(uint32_t phy_id,
 extern int ipq_qca8033_phy_init(struct phy_ops **ops, u32 phy_id);
 extern int ipq_qca8081_phy_init(struct phy_ops **ops, u32 phy_id);
 extern int ipq_qca_aquantia_phy_init(struct phy_ops **ops, u32 phy_id);
-extern int ipq_board_fw_download(unsigned int phy_addr);
+extern int ipq_board_fw_download_start(unsigned int phy_addr);
+extern int ipq_board_fw_download_finish(void);
 static int tftp_acl_our_port;
 
 /*
@@ -1765,6 +1766,10 @@ int ipq807x_edma_init(void *edma_board_cfg)
 #endif
 	int port_8033 = -1, node, phy_addr, aquantia_port = -1;
 	int mode, phy_node = -1;
+#ifdef CONFIG_QCA_AQUANTIA_PHY
+	int aq_phy_addr[PHY_MAX];
+	u32 aq_ports = 0;
+#endif
 
 	node = fdt_path_offset(gd->fdt_blob, "/ess-switch");
 	if (node >= 0)
@@ -1920,8 +1925,9 @@ int ipq807x_edma_init(void *edma_board_cfg)
 				case AQUANTIA_PHY_112:
 				case AQUANTIA_PHY_111B0:
 				case AQUANTIA_PHY_112C:
-					ipq_board_fw_download(phy_addr);
-					ipq_qca_aquantia_phy_init(&ipq807x_edma_dev[i]->ops[phy_id], phy_addr);
+					ipq_board_fw_download_start(phy_addr);
+					aq_phy_addr[phy_id] = phy_addr;
+					aq_ports |= 1 << phy_id;
 					break;
 #endif
 				default:
@@ -1932,6 +1938,19 @@ int ipq807x_edma_init(void *edma_board_cfg)
 			}
 		}
 
+#ifdef CONFIG_QCA_AQUANTIA_PHY
+		/*
+		 * Start the Aquantia firmware on all ports at once; the ops
+		 * talk to the running firmware, so map them afterwards.
+		 */
+		ipq_board_fw_download_finish();
+		for (phy_id = 0; phy_id < PHY_MAX; phy_id++) {
+			if (aq_ports & (1 << phy_id))
+				ipq_qca_aquantia_phy_init(&ipq807x_edma_dev[i]->ops[phy_id],
+							  aq_phy_addr[phy_id]);
+		}
+#endif
+
 		ret = ipq807x_edma_hw_init(hw[i]);
 
 		if (ret)
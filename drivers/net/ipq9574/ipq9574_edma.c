@@ -60,7 +60,8 @@ extern void ipq9574_qca8075_phy_interface_set_mode(uint32_t phy_id, uint32_t mod
 extern int ipq_qca8033_phy_init(struct phy_ops **ops, u32 phy_id);
 extern int ipq_qca8081_phy_init(struct phy_ops **ops, u32 phy_id);
 extern int ipq_qca_aquantia_phy_init(struct phy_ops **ops, u32 phy_id);
-extern int ipq_board_fw_download(unsigned int phy_addr);
+extern int ipq_board_fw_download_start(unsigned int phy_addr);
+extern int ipq_board_fw_download_finish(void);
 extern void ipq_set_mdio_mode(const int mode, const int bus);
 
 #ifdef CONFIG_QCA8084_PHY_MODE
@@ -1964,11 +1965,9 @@ int ipq9574_edma_init(void *edma_board_cfg)
 #endif
 	int node, phy_addr, mode, phy_node = -1, res = -1;
 	int aquantia_port[3] = {-1, -1, -1}, aquantia_port_cnt = -1;
-
-	/*
-	 * Init non cache buffer
-	 */
-	noncached_init();
+#ifdef CONFIG_IPQ9574_QCA_AQUANTIA_PHY
+	u32 aq_ports = 0;
+#endif
 
 	node = fdt_path_offset(gd->fdt_blob, "/ess-switch");
 
@@ -2191,9 +2190,8 @@ int ipq9574_edma_init(void *edma_board_cfg)
 				case AQUANTIA_PHY_113C_B0:
 				case AQUANTIA_PHY_113C_B1:
 				case MARVELL_PHY_X3410:
-					ipq_board_fw_download(phy_addr);
-					mdelay(100);
-					ipq_qca_aquantia_phy_init(&ipq9574_edma_dev[i]->ops[phy_id], phy_addr);
+					ipq_board_fw_download_start(phy_addr);
+					aq_ports |= 1 << phy_id;
 					break;
 #endif
 				default:
@@ -2204,6 +2202,24 @@ int ipq9574_edma_init(void *edma_board_cfg)
 			}
 		}
 
+#ifdef CONFIG_IPQ9574_QCA_AQUANTIA_PHY
+		/*
+		 * Start the Aquantia firmware on all ports at once; the ops
+		 * talk to the running firmware, so map them afterwards.
+		 */
+		ipq_board_fw_download_finish();
+		if (aq_ports)
+			mdelay(100);
+		for (phy_id = 0; phy_id < IPQ9574_PHY_MAX; phy_id++) {
+			if (!(aq_ports & (1 << phy_id)))
+				continue;
+			ipq_set_mdio_mode(mdio_info[phy_id]->mode,
+						mdio_info[phy_id]->bus_no);
+			ipq_qca_aquantia_phy_init(&ipq9574_edma_dev[i]->ops[phy_id],
+						  phy_info[phy_id]->phy_address);
+		}
+#endif
+
 		ret = ipq9574_edma_hw_init(hw[i]);
 
 		if (ret)
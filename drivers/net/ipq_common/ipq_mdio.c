@@ -19,6 +19,9 @@
 #include <phy.h>
 #include <asm/io.h>
 #include <errno.h>
+#ifdef CONFIG_IPQ_LAZY_INIT
+#include <asm/arch-qca-common/qca_common.h>
+#endif
 #include "ipq_mdio.h"
 
 #ifdef DEBUG
@@ -44,6 +47,20 @@ void ipq_set_mdio_mode(const int mode, const int bus)
 	bus_no = bus;
 }
 
+void ipq_get_mdio_mode(int *mode, int *bus)
+{
+	*mode = mdio_mode;
+	*bus = bus_no;
+}
+
+/* Debug commands can reach the bus before anything has brought up net */
+static inline void ipq_mdio_lazy_init(void)
+{
+#ifdef CONFIG_IPQ_LAZY_INIT
+	ipq_lazy_init(IPQ_LAZY_NET);
+#endif
+}
+
 static int ipq_mdio_wait_busy(void)
 {
 	int i;
@@ -64,6 +81,8 @@ int ipq_mdio_write1(int mii_id, int regnum, u16 value)
 {
 	u32 cmd;
 
+	ipq_mdio_lazy_init();
+
 	if (regnum & MII_ADDR_C45) {
 		unsigned int mmd = (regnum >> 16) & 0x1F;
 	        unsigned int reg = regnum & 0xFFFF;
@@ -115,6 +134,8 @@ int ipq_mdio_read1(int mii_id, int regnum, ushort *data)
 {
 	u32 val,cmd;
 
+	ipq_mdio_lazy_init();
+
 	if (regnum & MII_ADDR_C45) {
 
 		unsigned int mmd = (regnum >> 16) & 0x1F;
@@ -174,7 +195,10 @@ int ipq_mdio_write(int mii_id, int regnum, u16 value)
 	u32 cmd;
 #ifdef CONFIG_BITBANGMII
 	char name[16];
+#endif
 
+	ipq_mdio_lazy_init();
+#ifdef CONFIG_BITBANGMII
 	if (mdio_mode == MDIO_BITBANG) {
 		snprintf(name, sizeof(name), "MDIO%d", bus_no);
 
@@ -238,6 +262,10 @@ int ipq_mdio_read(int mii_id, int regnum, ushort *data)
 	u32 val,cmd;
 #ifdef CONFIG_BITBANGMII
 	char name[16];
+#endif
+
+	ipq_mdio_lazy_init();
+#ifdef CONFIG_BITBANGMII
 	if (mdio_mode == MDIO_BITBANG) {
 
 		snprintf(name, sizeof(name), "MDIO%d", bus_no);
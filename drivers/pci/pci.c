@@ -19,6 +19,9 @@
 #include <asm/processor.h>
 #include <asm/io.h>
 #include <pci.h>
+#ifdef CONFIG_IPQ_LAZY_INIT
+#include <asm/arch-qca-common/qca_common.h>
+#endif
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -109,6 +112,10 @@ static struct pci_controller* hose_head;
 
 struct pci_controller *pci_get_hose_head(void)
 {
+#ifdef CONFIG_IPQ_LAZY_INIT
+	/* Every bus lookup starts here, bring the controllers up first */
+	ipq_lazy_init(IPQ_LAZY_PCI);
+#endif
 	if (gd->hose)
 		return gd->hose;
 
@@ -267,6 +267,26 @@ int qup_bam_init(struct ipq_spi_slave *ds)
 	if (!qup_pipe_initialized)
 		qup_pipe_init();
 
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	/*
+	 * Keep the descriptor FIFO uncached so bam_add_one_desc() does
+	 * not have to flush every descriptor it queues.
+	 */
+	if (!qup_spi_data_desc_fifo) {
+		qup_spi_data_desc_fifo = (struct bam_desc *)noncached_alloc(
+				QUP_BAM_DATA_FIFO_SIZE * sizeof(struct bam_desc),
+				ARCH_DMA_MINALIGN);
+		if (!qup_spi_data_desc_fifo)
+			qup_spi_data_desc_fifo = memalign(ARCH_DMA_MINALIGN,
+				QUP_BAM_DATA_FIFO_SIZE *
+				sizeof(struct bam_desc));
+		if (!qup_spi_data_desc_fifo) {
+			printf("QUP: SPI: BAM FIFO allocation failed\n");
+			return FAILURE;
+		}
+	}
+#endif
+
 	/* Pipe numbers based on the QUP index */
 	if (ds->slave.bus == BLSP0_SPI) {
 		read_pipe_grp = QUP0_DATA_PRODUCER_PIPE_GRP;
@@ -649,6 +669,8 @@ static int blsp_spi_bam_begin_xfer(struct ipq_spi_slave *ds, const u8 *buffer,
 	int cons_flag = 0, prod_flag = 0;
 	int num_desc = 0;
 	u32 rem_bytes = 0;
+	const u8 *start = buffer;
+	u32 total = bytes;
 
 	rem_bytes = bytes;
 
@@ -715,10 +737,6 @@ static int blsp_spi_bam_begin_xfer(struct ipq_spi_slave *ds, const u8 *buffer,
 				bam_sys_gen_event(&bam, DATA_PRODUCER_PIPE_INDEX,
 						  num_desc);
 				blsp_spi_wait_for_data(DATA_PRODUCER_PIPE_INDEX);
-#if !defined(CONFIG_SYS_DCACHE_OFF)
-				flush_cache((unsigned long)buffer,
-					    (unsigned long)bytes);
-#endif
 				num_desc = 0;
 				rx_bytes_rcvd += data_xfer_size;
 				buffer = buffer + data_xfer_size;
@@ -733,6 +751,16 @@ static int blsp_spi_bam_begin_xfer(struct ipq_spi_slave *ds, const u8 *buffer,
 		return state_config;
 	}
 
+#if !defined(CONFIG_SYS_DCACHE_OFF)
+	/*
+	 * Drop whatever got speculatively cached while the BAM was writing,
+	 * once for the whole transfer rather than for the remaining buffer
+	 * after every chunk, which made multi-megabyte reads quadratic.
+	 */
+	if (type == READ)
+		flush_cache((unsigned long)start, (unsigned long)total);
+#endif
+
 	return ret;
 }
 
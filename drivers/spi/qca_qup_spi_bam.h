@@ -241,7 +241,12 @@ static inline struct ipq_spi_slave *to_ipq_spi(struct spi_slave *slave)
 #define QUP_BAM_DATA_FIFO_SIZE			32
 
 static struct bam_instance bam;
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+/* Allocated uncached by qup_bam_init() */
+struct bam_desc *qup_spi_data_desc_fifo;
+#else
 struct bam_desc qup_spi_data_desc_fifo[QUP_BAM_DATA_FIFO_SIZE] __attribute__ ((aligned(BAM_DESC_SIZE)));
+#endif
 
 #define CS_ASSERT				1
 #define CS_DEASSERT				0
@@ -25,6 +25,9 @@
 #include <linux/compat.h>
 #include <asm-generic/errno.h>
 #include <linux/usb/dwc3.h>
+#ifdef CONFIG_IPQ_LAZY_INIT
+#include <asm/arch-qca-common/qca_common.h>
+#endif
 #include "xhci.h"
 
 /* Declare global data pointer */
@@ -143,6 +146,10 @@ static int xhci_usb_probe(struct udevice *dev)
 		return -ENODEV;
 	}
 
+#ifdef CONFIG_IPQ_LAZY_INIT
+	/* Clocks and PHYs are only set up once USB is actually used */
+	ipq_lazy_init(IPQ_LAZY_USB);
+#endif
 	context->hcd = (struct xhci_hccr *)platdata->hcd_base;
 	context->dev = dev;
 	context->dwc3_reg = (struct dwc3 *)((char *)(context->hcd) + DWC3_REG_OFFSET);
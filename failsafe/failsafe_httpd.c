@@ -6,6 +6,7 @@
 #include <nand.h>
 #endif
 #include <ipq_api.h>
+#include <sysupgrade_parser.h>
 #include <asm/io.h>
 #include <spi_flash.h>
 #include <asm-generic/global_data.h>
@@ -21,6 +22,7 @@
 #include <webterm.h>
 #include <version.h>
 #include <fdtdec.h>
+#include <trace.h>
 #if defined(CONFIG_IPQ40XX) || defined(CONFIG_IPQ806X)
 #include <miiphy.h>
 #include <linux/mdio.h>
@@ -205,6 +207,8 @@ static void httpd_upload_progress(struct failsafe_httpd_state *hs) {
 }
 
 static void httpd_state_reset(struct failsafe_httpd_state *hs) {
+	if (hs->state == STATE_STREAM)
+		webterm_stream_detach(hs);
 	hs->state = STATE_NONE;
 	hs->last_activity = (u32_t)get_timer(0);
 	hs->dataptr = 0;
@@ -320,8 +324,15 @@ static int httpd_findandstore_firstchunk(struct failsafe_httpd_state *hs, char *
 		return 1;
 	}
 
+	/* Firmware images are parsed as they arrive, see sysupgrade_stream */
+	if (webfailsafe_upgrade_type == WEBFAILSAFE_UPGRADE_TYPE_FIRMWARE)
+		sysupgrade_upload_begin((void *)WEBFAILSAFE_UPLOAD_RAM_ADDRESS);
+	else
+		sysupgrade_upload_abort();
+
 	memcpy((void *)webfailsafe_data_pointer, (void *)end, hs->upload);
 	webfailsafe_data_pointer += hs->upload;
+	sysupgrade_upload_data(hs->upload);
 	upload.start_time = (u32_t)get_timer(0);
 	httpd_upload_progress(hs);
 	return 1;
@@ -399,8 +410,10 @@ static int httpd_check_upload_size(struct failsafe_httpd_state *hs) {
 static void httpd_upload_complete(struct failsafe_httpd_state *hs) {
 	if (upload.failed) {
 		printf("\nfailed!\n");
+		sysupgrade_upload_abort();
 	} else {
 		printf("  Done!\n");
+		sysupgrade_upload_end((unsigned long)hs->upload_total);
 	}
 	led_on("blink_led");
 	upload.done = 1;
@@ -441,6 +454,7 @@ static void httpd_handle_upload_data(struct failsafe_httpd_state *hs, char *data
 	} else if (bytes_to_write > 0) {
 		memcpy((void *)webfailsafe_data_pointer, (void *)data, bytes_to_write);
 		webfailsafe_data_pointer += bytes_to_write;
+		sysupgrade_upload_data(data_written + bytes_to_write);
 	}
 	httpd_upload_progress(hs);
 }
@@ -484,6 +498,31 @@ static void httpd_handle_upgrade_status(struct failsafe_httpd_state *hs) {
 	httpd_send_data(hs);
 }
 
+/* Handlers that touch flash, MDIO or the environment */
+static const char * const busy_paths[] = {
+	"/partitions", "/backup?", "/about", "/mac_info", "/led?", "/btn_detect",
+#ifdef CONFIG_TRACE
+	"/trace",
+#endif
+};
+
+static int httpd_path_needs_idle(const char *path) {
+	int i;
+	for (i = 0; i < ARRAY_SIZE(busy_paths); i++)
+		if (strncmp(path, busy_paths[i], strlen(busy_paths[i])) == 0)
+			return 1;
+	return 0;
+}
+
+/* The web terminal command may be in the middle of a flash operation */
+static void httpd_handle_busy(struct failsafe_httpd_state *hs) {
+	static const char resp[] = "HTTP/1.0 503 Service Unavailable\r\nCache-Control: no-cache\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\nbusy";
+	hs->state = STATE_FILE_REQUEST;
+	hs->dataptr = (u8_t *)resp;
+	hs->upload = sizeof(resp) - 1;
+	httpd_send_data(hs);
+}
+
 #define ABOUT_BUF_SIZE 4096
 static char about_json_buf[ABOUT_BUF_SIZE];
 
@@ -1166,6 +1205,67 @@ static void httpd_handle_mac_info(struct failsafe_httpd_state *hs) {
 	httpd_send_data(hs);
 }
 
+#ifdef CONFIG_BOOTSTAGE
+#define BOOTSTAGE_JSON_BUF_SIZE 8192
+
+static void httpd_handle_bootstage(struct failsafe_httpd_state *hs) {
+	static char buf[BOOTSTAGE_JSON_BUF_SIZE];
+	static const char err[] = "HTTP/1.0 500 Internal Server Error\r\nCache-Control: no-cache\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\nbootstage";
+	char hdr[128];
+	int pos, hdr_len;
+
+	hs->state = STATE_FILE_REQUEST;
+	pos = bootstage_json(buf, sizeof(buf) - sizeof(hdr));
+	if (pos < 0 || pos >= sizeof(buf) - sizeof(hdr)) {
+		hs->dataptr = (u8_t *)err;
+		hs->upload = sizeof(err) - 1;
+		httpd_send_data(hs);
+		return;
+	}
+
+	hdr_len = sprintf(hdr, "HTTP/1.0 200 OK\r\nCache-Control: no-cache\r\nContent-Type: application/json\r\nContent-Length: %d\r\nConnection: close\r\n\r\n", pos);
+	memmove(buf + hdr_len, buf, pos);
+	memcpy(buf, hdr, hdr_len);
+
+	hs->dataptr = (u8_t *)buf;
+	hs->upload = hdr_len + pos;
+	httpd_send_data(hs);
+}
+#endif
+
+#ifdef CONFIG_TRACE
+/*
+ * Function list followed by the call list, as 'trace funclist' and
+ * 'trace calls' would dump them, so proftool can read the download.
+ * Built in the upload area, which the busy check keeps free for us.
+ */
+static void httpd_handle_trace(struct failsafe_httpd_state *hs) {
+	static const char err[] = "HTTP/1.0 500 Internal Server Error\r\nCache-Control: no-cache\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\ntrace";
+	char hdr[192], *buf = (char *)WEBFAILSAFE_UPLOAD_RAM_ADDRESS;
+	u32_t avail = (u32_t)CONFIG_SYS_SDRAM_END - (u32_t)WEBFAILSAFE_UPLOAD_RAM_ADDRESS - sizeof(hdr);
+	unsigned int funcs, calls;
+	int hdr_len;
+
+	hs->state = STATE_FILE_REQUEST;
+	if (trace_list_functions(buf + sizeof(hdr), avail, &funcs) ||
+		trace_list_calls(buf + sizeof(hdr) + funcs, avail - funcs, &calls)) {
+		hs->dataptr = (u8_t *)err;
+		hs->upload = sizeof(err) - 1;
+		httpd_send_data(hs);
+		return;
+	}
+
+	hdr_len = sprintf(hdr, "HTTP/1.0 200 OK\r\n" "Content-Type: application/octet-stream\r\n"
+		"Content-Disposition: attachment; filename=\"trace.bin\"\r\n" "Content-Length: %u\r\n" "Connection: close\r\n\r\n", funcs + calls);
+	buf += sizeof(hdr) - hdr_len;
+	memcpy(buf, hdr, hdr_len);
+
+	hs->dataptr = (u8_t *)buf;
+	hs->upload = hdr_len + funcs + calls;
+	httpd_send_data(hs);
+}
+#endif
+
 static void httpd_handle_mac_set(struct failsafe_httpd_state *hs, char *data, int data_len) {
 	static char resp[128];
 	int len, ok = 0, type = -1, index = -1;
@@ -1600,6 +1700,11 @@ static err_t httpd_sent(void *arg, struct tcp_pcb *pcb, u16_t len) {
 
 	hs->last_activity = (u32_t)get_timer(0);
 
+	if (hs->state == STATE_STREAM) {
+		webterm_stream_poll();
+		return ERR_OK;
+	}
+
 	if (backup.sending_header && hs->upload <= 0) {
 		backup.sending_header = 0;
 		hs->state = STATE_FILE_REQUEST;
@@ -1674,11 +1779,27 @@ static err_t httpd_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t er
 				httpd_handle_upgrade_status(hs);
 				break;
 			}
+#ifdef CONFIG_BOOTSTAGE
+			if (strncmp(&data[4], "/bootstage", 10) == 0 && data[14] == ISO_space) {
+				httpd_handle_bootstage(hs);
+				break;
+			}
+#endif
+			if (webterm_command_running() && httpd_path_needs_idle(&data[4])) {
+				httpd_handle_busy(hs);
+				break;
+			}
 			if (strncmp(&data[4], "/partitions", 11) == 0 &&
 				data[15] == ISO_space) {
 				httpd_handle_partitions(hs);
 				break;
 			}
+#ifdef CONFIG_TRACE
+			if (strncmp(&data[4], "/trace", 6) == 0 && data[10] == ISO_space) {
+				httpd_handle_trace(hs);
+				break;
+			}
+#endif
 			if (strncmp(&data[4], "/backup?", 8) == 0) {
 				httpd_handle_backup(hs, data, data_len);
 				break;
@@ -1705,6 +1826,10 @@ static err_t httpd_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t er
 				webterm_http_handler(hs, data, data_len);
 				break;
 			}
+			if (webterm_command_running()) {
+				httpd_handle_busy(hs);
+				break;
+			}
 			if (strncmp(&data[5], "/env_set", 8) == 0) {
 				httpd_handle_env_set(hs, data, data_len);
 				break;
@@ -1756,6 +1881,7 @@ static err_t httpd_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t er
 		break;
 
 	case STATE_FILE_REQUEST:
+	case STATE_STREAM:
 		break;
 	}
 
@@ -1780,6 +1906,11 @@ static err_t httpd_poll_cb(void *arg, struct tcp_pcb *pcb) {
 	if (hs == NULL)
 		return ERR_OK;
 
+	if (hs->state == STATE_STREAM) {
+		webterm_stream_poll();
+		return ERR_OK;
+	}
+
 	if (get_timer(hs->last_activity) >= 300000) {
 		if (hs == hs_global)
 			hs_global = NULL;
@@ -1852,6 +1983,8 @@ static void abort_port_pcb(struct tcp_pcb **list) {
 	for (pcb = *list; pcb != NULL; pcb = next) {
 		next = pcb->next;
 		if (pcb->local_port == 80) {
+			if (pcb->callback_arg)
+				webterm_stream_detach(pcb->callback_arg);
 			tcp_arg(pcb, NULL);
 			tcp_err(pcb, NULL);
 			tcp_recv(pcb, NULL);
@@ -1869,6 +2002,7 @@ void failsafe_httpd_stop(void) {
 	}
 	abort_port_pcb(&tcp_active_pcbs);
 	abort_port_pcb(&tcp_tw_pcbs);
+	webterm_stream_stop();
 	hs_global = NULL;
 	netif_remove(&failsafe_netif);
 	httpd_progress_start_done = 0;
@@ -1981,6 +2115,8 @@ void failsafe_httpd_poll(void) {
 	}
 
 	sys_check_timeouts();
+	/* Console output is only queued by the capture hook, send it here */
+	webterm_stream_poll();
 
 	if (get_timer(periodic_timer) >= 500) {
 		periodic_timer = now;
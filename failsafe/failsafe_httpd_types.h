@@ -7,6 +7,7 @@
 #define STATE_NONE            0
 #define STATE_FILE_REQUEST    1
 #define STATE_UPLOAD_REQUEST  2
+#define STATE_STREAM          3
 
 #define ISO_slash   0x2f
 
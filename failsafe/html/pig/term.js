@@ -2,6 +2,7 @@
 	var URL = {
 		STATUS: '/webterm/status',
 		DATA: '/webterm/data',
+		STREAM: '/webterm/stream',
 		CMD: '/webterm/cmd',
 		ABORT: '/webterm/abort'
 	};
@@ -15,14 +16,52 @@
 
 	var pollTimer = null;
 	var lastSeq = -1;
+	var streaming = false;
+	var canStream = !!(window.ReadableStream && window.TextDecoder);
 
 	function postCommand(body) {
 		return fetch(URL.CMD, { method: 'POST', headers: CMD_HEADERS, body: body });
 	}
 
 	function restartPoll(delay) {
+		if (streaming) return;
 		clearTimeout(pollTimer);
-		pollTimer = setTimeout(fetchStatus, delay);
+		pollTimer = setTimeout(canStream ? openStream : fetchStatus, delay);
+	}
+
+	function setConnected(ok) {
+		connectionStatus.textContent = ok ? '✓' : '✗';
+		connectionStatus.style.color = ok ? 'green' : 'red';
+	}
+
+	function appendOutput(text) {
+		terminalOutput.textContent += text;
+		terminalOutput.scrollTop = terminalOutput.scrollHeight;
+		updateButtonStyles();
+	}
+
+	async function openStream() {
+		var ok = false;
+		streaming = true;
+		try {
+			var response = await fetch(URL.STREAM, FETCH_OPTS);
+			if (response.ok && response.body) {
+				var reader = response.body.getReader();
+				var decoder = new TextDecoder();
+				setConnected(ok = true);
+				for (;;) {
+					var r = await reader.read();
+					if (r.done) break;
+					var text = decoder.decode(r.value, { stream: true });
+					if (text) appendOutput(text);
+				}
+			} else if (response.status === 404) {
+				canStream = false;
+			}
+		} catch (error) {}
+		streaming = false;
+		setConnected(false);
+		restartPoll(ok ? POLL_FAST : POLL_INTERVAL);
 	}
 
 	function restartPollFast() {
@@ -43,8 +82,7 @@
 				ok = true;
 			}
 		} catch (error) {}
-		connectionStatus.textContent = ok ? '✓' : '✗';
-		connectionStatus.style.color = ok ? 'green' : 'red';
+		setConnected(ok);
 		restartPoll(hasNewData ? POLL_FAST : POLL_INTERVAL);
 	}
 
@@ -52,11 +90,7 @@
 		try {
 			var response = await fetch(URL.DATA, FETCH_OPTS);
 			var text = await response.text();
-			if (text) {
-				terminalOutput.textContent += text;
-				terminalOutput.scrollTop = terminalOutput.scrollHeight;
-				updateButtonStyles();
-			}
+			if (text) appendOutput(text);
 		} catch (error) {}
 	}
 
@@ -199,6 +199,18 @@ enum bootstage_id {
 	BOOTSTAGE_ID_ACCUM_SPI,
 	BOOTSTAGE_ID_ACCUM_DECOMP,
 
+	/* IPQ board phases, each one a start/done pair */
+	BOOTSTAGE_ID_SMEM_PTABLE,
+	BOOTSTAGE_ID_SMEM_PTABLE_DONE,
+	BOOTSTAGE_ID_PART_DETAILS,
+	BOOTSTAGE_ID_PART_DETAILS_DONE,
+	BOOTSTAGE_ID_BOARD_ETH_INIT,
+	BOOTSTAGE_ID_BOARD_ETH_INIT_DONE,
+	BOOTSTAGE_ID_UBI_ATTACH,
+	BOOTSTAGE_ID_UBI_ATTACH_DONE,
+	BOOTSTAGE_ID_FDT_FIXUP,
+	BOOTSTAGE_ID_FDT_FIXUP_DONE,
+
 	/* a few spare for the user, from here */
 	BOOTSTAGE_ID_USER,
 	BOOTSTAGE_ID_COUNT = BOOTSTAGE_ID_USER + CONFIG_BOOTSTAGE_USER_COUNT,
@@ -308,6 +320,25 @@ void bootstage_report(void);
  */
 int bootstage_fdt_add_report(void);
 
+/**
+ * Add bootstage information to a given device tree, replacing any
+ * /bootstage node it already has
+ *
+ * @param blob	Device tree blob
+ * @return 0 if ok, -ve on error
+ */
+int bootstage_fdt_add(void *blob);
+
+/**
+ * Write the records, in time order, as a JSON object
+ *
+ * @param buf	Buffer to write to
+ * @param size	Size of buffer
+ * @return length of the JSON text; if this is not less than size the
+ *		output was truncated
+ */
+int bootstage_json(char *buf, int size);
+
 /*
  * Stash bootstage data into memory
  *
@@ -380,6 +411,11 @@ static inline uint32_t bootstage_accum(enum bootstage_id id)
 	return 0;
 }
 
+static inline int bootstage_fdt_add(void *blob)
+{
+	return 0;
+}
+
 static inline int bootstage_stash(void *base, int size)
 {
 	return 0;	/* Pretend to succeed */
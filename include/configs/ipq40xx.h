@@ -26,10 +26,25 @@
 
 #define CONFIG_IPQ40XX
 #define CONFIG_IPQ_NO_RELOC
+
+/*
+ * Function tracing, built with FTRACE=1. The buffer is hidden from the
+ * top of DRAM so uploads and the kernel do not overwrite it.
+ */
+#ifdef FTRACE
+#define CONFIG_TRACE
+#define CONFIG_CMD_TRACE
+#define CONFIG_TRACE_BUFFER_SIZE	(8 << 20)
+#define CONFIG_SYS_MEM_TOP_HIDE		CONFIG_TRACE_BUFFER_SIZE
+#endif
+
 #define CONFIG_BOARD_EARLY_INIT_F
 #define CONFIG_SYS_NO_FLASH
 #define CONFIG_SYS_CACHELINE_SIZE	64
 #define CONFIG_SKIP_LOWLEVEL_INIT
+#define CONFIG_USE_ARCH_MEMCPY
+#define CONFIG_USE_ARCH_MEMMOVE
+#define CONFIG_USE_ARCH_MEMSET
 #define CONFIG_SYS_HZ			1000
 #define CONFIG_SYS_VSNPRINTF
 #define CONFIG_IPQ40XX_UART
@@ -134,6 +149,7 @@ typedef struct {
 /* Environment */
 #define CONFIG_ARCH_CPU_INIT
 #define CONFIG_BOARD_LATE_INIT
+#define CONFIG_IPQ_LAZY_INIT
 #define CONFIG_ENV_OFFSET		board_env_offset
 #define CONFIG_ENV_SIZE		CONFIG_ENV_SIZE_MAX
 #define CONFIG_ENV_RANGE		board_env_range
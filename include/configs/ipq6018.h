@@ -23,15 +23,30 @@
 
 #define CONFIG_BOARD_EARLY_INIT_F
 #define CONFIG_BOARD_LATE_INIT
+#define CONFIG_IPQ_LAZY_INIT
 #define CONFIG_SYS_NO_FLASH
 #define CONFIG_SYS_VSNPRINTF
 #define CONFIG_IPQ_NO_RELOC
 
+/*
+ * Function tracing, built with FTRACE=1. The buffer is hidden from the
+ * top of DRAM so uploads and the kernel do not overwrite it.
+ */
+#ifdef FTRACE
+#define CONFIG_TRACE
+#define CONFIG_CMD_TRACE
+#define CONFIG_TRACE_BUFFER_SIZE	(16 << 20)
+#define CONFIG_SYS_MEM_TOP_HIDE		CONFIG_TRACE_BUFFER_SIZE
+#endif
+
 #define CONFIG_SYS_NONCACHED_MEMORY     (1 << 20)
 
 #define CONFIG_IPQ6018_UART
 #define CONFIG_NR_DRAM_BANKS		1
 #define CONFIG_SKIP_LOWLEVEL_INIT
+#define CONFIG_USE_ARCH_MEMCPY
+#define CONFIG_USE_ARCH_MEMMOVE
+#define CONFIG_USE_ARCH_MEMSET
 
 #define CONFIG_SYS_BOOTM_LEN		0x4000000
 
@@ -35,6 +35,18 @@
 
 #define CONFIG_IPQ806X
 #define CONFIG_IPQ_NO_RELOC
+
+/*
+ * Function tracing, built with FTRACE=1. The buffer is hidden from the
+ * top of DRAM so uploads and the kernel do not overwrite it.
+ */
+#ifdef FTRACE
+#define CONFIG_TRACE
+#define CONFIG_CMD_TRACE
+#define CONFIG_TRACE_BUFFER_SIZE	(16 << 20)
+#define CONFIG_SYS_MEM_TOP_HIDE		CONFIG_TRACE_BUFFER_SIZE
+#endif
+
 #define CONFIG_SMP_CMD_SUPPORT
 #ifdef CONFIG_SMP_CMD_SUPPORT
 #define NR_CPUS				2
@@ -74,6 +86,9 @@
 #undef CONFIG_SYS_MAX_FLASH_SECT
 #define CONFIG_NR_DRAM_BANKS            1
 #define CONFIG_SKIP_LOWLEVEL_INIT
+#define CONFIG_USE_ARCH_MEMCPY
+#define CONFIG_USE_ARCH_MEMMOVE
+#define CONFIG_USE_ARCH_MEMSET
 #define CONFIG_CMD_PING
 
 #define CONFIG_IPQ_SNPS_GMAC
@@ -347,6 +362,7 @@ typedef struct {
 #define CONFIG_BOOTCOMMAND  "bootipq"
 
 #define CONFIG_BOARD_LATE_INIT
+#define CONFIG_IPQ_LAZY_INIT
 
 #define CONFIG_ENV_IS_IN_NAND
 #define CONFIG_ENV_OFFSET board_env_offset
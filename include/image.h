@@ -901,6 +901,26 @@ int fit_add_verification_data(const char *keydir, void *keydest, void *fit,
 
 int fit_image_verify(const void *fit, int noffset);
 int fit_config_verify(const void *fit, int conf_noffset);
+#ifndef USE_HOSTCC
+/**
+ * fit_image_hash_set_verified() - record a hash checked while loading
+ *
+ * @fit:	Pointer to the FIT format image header
+ * @noffset:	Hash node offset
+ * @value:	Hash value computed over the image data
+ * @value_len:	Length of @value
+ *
+ * For loaders that hash the image data as it is read from storage. The
+ * next fit_image_verify() of the hash node accepts it without rehashing
+ * the data, provided the node still holds @value. Each record is used
+ * once; fit_image_hash_clear_verified() drops all of them.
+ */
+#define FIT_MAX_PREVERIFIED	32	/* records held at once */
+
+void fit_image_hash_set_verified(const void *fit, int noffset,
+				 const uint8_t *value, int value_len);
+void fit_image_hash_clear_verified(void);
+#endif
 int fit_all_image_verify(const void *fit);
 int fit_image_check_os(const void *fit, int noffset, uint8_t os);
 int fit_image_check_arch(const void *fit, int noffset, uint8_t arch);
@@ -241,7 +241,13 @@ typedef int	wait_queue_head_t;
 #define up_read(...)			do { } while (0)
 #define up_write(...)			do { } while (0)
 
+#if defined(CONFIG_LWIP_HTTPD) && !defined(CONFIG_SPL_BUILD)
+/* Lets the failsafe web server run while a web terminal command works */
+void webterm_yield(void);
+#define cond_resched()			webterm_yield()
+#else
 #define cond_resched()			do { } while (0)
+#endif
 #define yield()				do { } while (0)
 
 #define __init
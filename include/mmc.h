@@ -180,6 +180,8 @@
 #define SD_SWITCH_SWITCH	1
 
 #define MMC_RESP_TIMEOUT		2000
+#define MMC_TRIM_MAX_TIMEOUT		60000
+#define MMC_SANITIZE_TIMEOUT		240000
 #define MMC_ADDR_OUT_OF_RANGE(resp)	((resp >> 31) & 0x01)
 
 /*
@@ -201,6 +203,7 @@
 #define EXT_CSD_MAX_ENH_SIZE_MULT	157	/* R */
 #define EXT_CSD_PARTITIONING_SUPPORT	160	/* RO */
 #define EXT_CSD_RST_N_FUNCTION		162	/* R/W */
+#define EXT_CSD_SANITIZE_START		165	/* W */
 #define EXT_CSD_WR_REL_PARAM		166	/* R */
 #define EXT_CSD_WR_REL_SET		167	/* R/W */
 #define EXT_CSD_RPMB_MULT		168	/* RO */
@@ -221,6 +224,7 @@
 
 #define EXT_CSD_SEC_ER_EN       (1 << 0)
 #define EXT_CSD_SEC_GB_CL_EN    (1 << 4)
+#define EXT_CSD_SEC_SANITIZE    (1 << 6)
 /*
  * EXT_CSD field definitions
  */
@@ -378,6 +382,14 @@ struct mmc_ops {
 	int (*init)(struct mmc *mmc);
 	int (*getcd)(struct mmc *mmc);
 	int (*getwp)(struct mmc *mmc);
+	/*
+	 * Optional split data transfer: send_cmd_async returns once the
+	 * command is accepted, data_poll returns -EBUSY until the data
+	 * phase has completed and then its status.
+	 */
+	int (*send_cmd_async)(struct mmc *mmc,
+			struct mmc_cmd *cmd, struct mmc_data *data);
+	int (*data_poll)(struct mmc *mmc);
 };
 
 struct mmc_config {
@@ -436,6 +448,11 @@ struct mmc {
 	uchar sec_feature_support;
 	unsigned int trim_timeout; /* In milliseconds */
 	u32 quirks;
+	/* Outstanding mmc_bread_start() request */
+	void *async_dst;
+	lbaint_t async_blkcnt;
+	int async_busy;
+	int async_err;
 };
 
 struct mmc_hwpart_conf {
@@ -465,6 +482,11 @@ void mmc_destroy(struct mmc *mmc);
 int mmc_initialize(bd_t *bis);
 int mmc_init(struct mmc *mmc);
 int mmc_read(struct mmc *mmc, u64 src, uchar *dst, int size);
+int mmc_bread_start(int dev_num, lbaint_t start, lbaint_t blkcnt, void *dst);
+int mmc_bread_poll(int dev_num);
+ulong mmc_bread_finish(int dev_num);
+unsigned long mmc_btrim(int dev_num, lbaint_t start, lbaint_t blkcnt);
+int mmc_sanitize(struct mmc *mmc);
 void mmc_set_clock(struct mmc *mmc, uint clock);
 struct mmc *find_mmc_device(int dev_num);
 int mmc_set_dev(int dev_num);
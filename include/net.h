@@ -522,6 +522,15 @@ extern ushort		net_native_vlan;	/* Our Native VLAN */
 
 extern int		net_restart_wrap;	/* Tried all network devices */
 extern int 		tftp_our_port;
+#ifdef CONFIG_CMD_TFTPPUT
+/*
+ * When set, tftpput asks this for each block instead of reading save_addr,
+ * so data produced on the fly can be sent without staging it in memory.
+ * Offsets only move forward, apart from resending the last block. Returning
+ * less than len ends the transfer; save_size is then only an upper bound.
+ */
+extern int (*tftp_put_source)(ulong offset, uchar *dst, unsigned len);
+#endif
 enum proto_t {
     BOOTP, RARP, ARP, TFTPGET, DHCP, PING, DNS, NFS, CDP, NETCONS, SNTP,
     TFTPSRV, TFTPPUT, LINKLOCAL
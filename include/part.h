@@ -199,6 +199,26 @@ void print_part_efi (block_dev_desc_t *dev_desc);
 int   test_part_efi (block_dev_desc_t *dev_desc);
 int get_partition_count_efi(block_dev_desc_t * dev_desc);
 
+/**
+ * gpt_cache_invalidate() - Forget the cached GPT of a block device
+ *
+ * @param dev_desc - block device descriptor, NULL for all devices
+ */
+void gpt_cache_invalidate(block_dev_desc_t *dev_desc);
+
+/**
+ * gpt_cache_write_notify() - Tell the GPT cache about a raw block write
+ *
+ * Drops the cached GPT of @dev_desc when the range overlaps the primary
+ * or backup GPT area.
+ *
+ * @param dev_desc - block device descriptor
+ * @param start - first block written
+ * @param blkcnt - number of blocks written
+ */
+void gpt_cache_write_notify(block_dev_desc_t *dev_desc, lbaint_t start,
+			    lbaint_t blkcnt);
+
 /**
  * write_gpt_table() - Write the GUID Partition Table to disk
  *
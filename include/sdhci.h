@@ -292,6 +292,13 @@ struct sdhci_host {
 	uint	voltages;
 
 	struct mmc_config cfg;
+#ifdef CONFIG_MMC_ADMA
+	struct adma_desc *adma_pending;	/* descriptors of a split transfer */
+	ulong adma_start;
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	struct adma_desc *adma_table;	/* uncached descriptor table */
+#endif
+#endif
 };
 
 #if defined(CONFIG_QCA_MMC) && defined(CONFIG_SDHCI_SUPPORT)
@@ -53,6 +53,10 @@ struct hsearch_data {
 	struct _ENTRY *table;
 	unsigned int size;
 	unsigned int filled;
+	/* Table indices of the used entries, sorted by key */
+	unsigned int *sorted;
+	/* Set when an entry is added, changed or deleted, cleared by users */
+	int dirty;
 /*
  * Callback function which will check whether the given change for variable
  * "item" to "newval" may be applied or not, and possibly apply such change.
@@ -80,8 +84,10 @@ extern int hsearch_r(ENTRY __item, ACTION __action, ENTRY ** __retval,
 		     struct hsearch_data *__htab, int __flag);
 
 /*
- * Search for an entry matching `MATCH'.  Otherwise, Same semantics
- * as hsearch_r().
+ * Search for the entries whose key starts with `MATCH', in ascending key
+ * order.  Start with LAST_IDX 0 and pass the previous return value to
+ * get the next one; 0 is returned when there are no more matches.  The
+ * table must not be modified in between.
  */
 extern int hmatch_r(const char *__match, int __last_idx, ENTRY ** __retval,
 		    struct hsearch_data *__htab);
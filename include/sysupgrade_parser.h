@@ -10,6 +10,33 @@ typedef struct {
 
 #define sysupgrade_parts_valid(p) ((p)->kernel_data || (p)->rootfs_data)
 
+/* Incremental parser state, fed as the image bytes land in RAM */
+typedef struct {
+	const u8 *base;
+	unsigned long received;
+	unsigned long pos;
+	unsigned long member_end;
+	int state;
+	int header_off;
+	int entries;
+	int *member;
+	int kernel_done;
+	int rootfs_done;
+	int active;
+	int complete;
+	u64 bytes_used;
+	sysupgrade_fw_parts parts;
+} sysupgrade_stream;
+
+void sysupgrade_stream_init(sysupgrade_stream *s, const void *address);
+void sysupgrade_stream_feed(sysupgrade_stream *s, unsigned long received);
+sysupgrade_fw_parts sysupgrade_stream_finish(sysupgrade_stream *s);
+
+void sysupgrade_upload_begin(void *address);
+void sysupgrade_upload_data(unsigned long received);
+void sysupgrade_upload_end(unsigned long size);
+void sysupgrade_upload_abort(void);
+
 sysupgrade_fw_parts parse_sysupgrade_firmware(void *address);
 #ifdef CONFIG_CMD_UBI
 int sysupgrade_ubi_init(void);
@@ -46,6 +46,16 @@ struct trace_output_hdr {
 /* Print statistics about traced function calls */
 void trace_print_stats(void);
 
+/**
+ * Print the functions with the most time spent in them
+ *
+ * Times come from pairing the entry and exit records in the call list, so
+ * only calls that fitted in the trace buffer are counted.
+ *
+ * @param count		Number of functions to print
+ */
+void trace_print_top(int count);
+
 /**
  * Dump a list of functions and call counts into a buffer
  *
@@ -79,7 +79,14 @@ extern int ubi_init(void);
 extern void ubi_exit(void);
 extern int ubi_part(char *part_name, const char *vid_header_offset);
 extern int ubi_volume_write(char *volume, void *buf, size_t size);
+extern int ubi_volume_prepare(char *volume, size_t size);
+extern int ubi_volume_remove(char *volume);
+extern int ubi_volume_write_multi(char * const volumes[], int count,
+				  const void *buf, size_t size);
 extern int ubi_volume_read(char *volume, char *buf, size_t size);
+extern int ubi_volume_read_at(char *volume, char *buf, loff_t offp,
+			      size_t size);
+extern long long ubi_get_volume_size(char *volume);
 
 extern struct ubi_device *ubi_devices[];
 
@@ -30,5 +30,12 @@ void webterm_puts(const char *str);
 void webterm_putc(const char c);
 
 int webterm_run_pending_command(void);
+int webterm_command_running(void);
+void webterm_yield(void);
+
+/* Push pending output to the /webterm/stream client, if any */
+void webterm_stream_poll(void);
+void webterm_stream_detach(struct failsafe_httpd_state *hs);
+void webterm_stream_stop(void);
 
 #endif /* _WEBTERM_H_ */
\ No newline at end of file
@@ -17,9 +17,10 @@
  */
 
 #include <div64.h>
+#include <linux/compiler.h>
 #include <linux/types.h>
 
-uint32_t __div64_32(uint64_t *n, uint32_t base)
+uint32_t notrace __div64_32(uint64_t *n, uint32_t base)
 {
 	uint64_t rem = *n;
 	uint64_t b = base;
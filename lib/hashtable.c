@@ -58,7 +58,8 @@
  */
 
 typedef struct _ENTRY {
-	int used;
+	int used;		/* 0: empty, 1: in use, -1: deleted */
+	unsigned int hval;	/* full hash of entry.key */
 	ENTRY entry;
 } _ENTRY;
 
@@ -70,31 +71,19 @@ static void _hdelete(const char *key, struct hsearch_data *htab, ENTRY *ep,
  * hcreate()
  */
 
-/*
- * For the used double hash method the table size has to be a prime. To
- * correct the user given table size we need a prime test.  This trivial
- * algorithm is adequate because
- * a)  the code is (most probably) called a few times per program run and
- * b)  the number is small because the table must fit in the core
- * */
-static int isprime(unsigned int number)
-{
-	/* no even number will be passed */
-	unsigned int div = 3;
-
-	while (div * div < number && number % div != 0)
-		div += 2;
-
-	return number % div != 0;
-}
-
 /*
  * Before using the hash table we must allocate memory for it.
- * Test for an existing table are done. We allocate one element
- * more as the found prime number says. This is done for more effective
- * indexing as explained in the comment for the hsearch function.
+ * Test for an existing table are done. The table size is a power of
+ * two with at least a quarter of the slots left free when NEL entries
+ * are stored, so the probe sequences stay short. We allocate one element
+ * more as the size says. This is done for more effective indexing as
+ * explained in the comment for the hsearch function.
  * The contents of the table is zeroed, especially the field used
  * becomes zero.
+ *
+ * Next to the table a key index is kept: the table indices of all used
+ * entries, sorted by key. It lets hexport() and hmatch() walk the
+ * entries in order without sorting them on every call.
  */
 
 int hcreate_r(size_t nel, struct hsearch_data *htab)
@@ -109,12 +98,11 @@ int hcreate_r(size_t nel, struct hsearch_data *htab)
 	if (htab->table != NULL)
 		return 0;
 
-	/* Change nel to the first prime number not smaller as nel. */
-	nel |= 1;		/* make odd */
-	while (!isprime(nel))
-		nel += 2;
-
-	htab->size = nel;
+	/* Round nel + 25% up to the next power of two. */
+	nel += nel / 4;
+	htab->size = 8;
+	while (htab->size < nel)
+		htab->size <<= 1;
 	htab->filled = 0;
 
 	/* allocate memory and zero out */
@@ -122,6 +110,13 @@ int hcreate_r(size_t nel, struct hsearch_data *htab)
 	if (htab->table == NULL)
 		return 0;
 
+	htab->sorted = calloc(htab->size, sizeof(unsigned int));
+	if (htab->sorted == NULL) {
+		free(htab->table);
+		htab->table = NULL;
+		return 0;
+	}
+
 	/* everything went alright */
 	return 1;
 }
@@ -156,9 +151,12 @@ void hdestroy_r(struct hsearch_data *htab)
 		}
 	}
 	free(htab->table);
+	free(htab->sorted);
 
 	/* the sign for an existing table is an value != NULL in htable */
 	htab->table = NULL;
+	htab->sorted = NULL;
+	htab->filled = 0;
 }
 
 /*
@@ -166,19 +164,22 @@ void hdestroy_r(struct hsearch_data *htab)
  */
 
 /*
- * This is the search function. It uses double hashing with open addressing.
- * The argument item.key has to be a pointer to an zero terminated, most
- * probably strings of chars. The function for generating a number of the
- * strings is simple but fast. It can be replaced by a more complex function
- * like ajw (see [Aho,Sethi,Ullman]) if the needs are shown.
+ * This is the search function. It uses open addressing with triangular
+ * probing (steps of 1, 2, 3, ...), which visits every slot of a power of
+ * two sized table. The argument item.key has to be a pointer to an zero
+ * terminated, most probably strings of chars. The key is hashed with
+ * FNV-1a followed by the MurmurHash3 finalizer, so that the low bits
+ * used to pick the slot depend on every character of the key; the
+ * environment is full of names sharing long prefixes and suffixes
+ * (bootargs, bootcmd, ..., eth1addr, eth2addr, ...).
  *
  * We use an trick to speed up the lookup. The table is created by hcreate
  * with one more element available. This enables us to use the index zero
- * special. This index will never be used because we store the first hash
- * index in the field used where zero means not used. Every other value
- * means used. The used field can be used as a first fast comparison for
- * equality of the stored and the parameter value. This helps to prevent
- * unnecessary expensive calls of strcmp.
+ * special. This index will never be used, slot N of the probe sequence
+ * lives at index N + 1. The full hash value of every key is kept in the
+ * entry and is used as a first fast comparison for equality of the stored
+ * and the parameter value. This helps to prevent unnecessary expensive
+ * calls of strcmp.
  *
  * This implementation differs from the standard library version of
  * this function in a number of ways:
@@ -198,18 +199,66 @@ void hdestroy_r(struct hsearch_data *htab)
  *   example for functions like hdelete().
  */
 
+static unsigned int hstr(const char *key)
+{
+	unsigned int hval = 2166136261u;
+
+	while (*key) {
+		hval ^= (unsigned char)*key++;
+		hval *= 16777619;
+	}
+
+	hval ^= hval >> 16;
+	hval *= 0x85ebca6b;
+	hval ^= hval >> 13;
+	hval *= 0xc2b2ae35;
+	hval ^= hval >> 16;
+
+	return hval;
+}
+
+/*
+ * Return the position of the first key in the sorted index which is not
+ * smaller than the given one.
+ */
+static unsigned int hsorted_pos(struct hsearch_data *htab, const char *key)
+{
+	unsigned int lo = 0, hi = htab->filled;
+
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+
+		if (strcmp(htab->table[htab->sorted[mid]].entry.key, key) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/*
+ * Since the index is sorted, all keys starting with the given prefix are
+ * adjacent. The return value is a cursor into the index (position + 1)
+ * and is passed back as last_idx to get the next match.
+ */
 int hmatch_r(const char *match, int last_idx, ENTRY ** retval,
 	     struct hsearch_data *htab)
 {
-	unsigned int idx;
+	unsigned int pos;
 	size_t key_len = strlen(match);
 
-	for (idx = last_idx + 1; idx < htab->size; ++idx) {
-		if (htab->table[idx].used <= 0)
-			continue;
-		if (!strncmp(match, htab->table[idx].entry.key, key_len)) {
-			*retval = &htab->table[idx].entry;
-			return idx;
+	if (last_idx > 0)
+		pos = last_idx;
+	else
+		pos = hsorted_pos(htab, match);
+
+	if (pos < htab->filled) {
+		ENTRY *ep = &htab->table[htab->sorted[pos]].entry;
+
+		if (!strncmp(match, ep->key, key_len)) {
+			*retval = ep;
+			return pos + 1;
 		}
 	}
 
@@ -226,7 +275,7 @@ static inline int _compare_and_overwrite_entry(ENTRY item, ACTION action,
 	ENTRY **retval, struct hsearch_data *htab, int flag,
 	unsigned int hval, unsigned int idx)
 {
-	if (htab->table[idx].used == hval
+	if (htab->table[idx].hval == hval
 	    && strcmp(item.key, htab->table[idx].entry.key) == 0) {
 		/* Overwrite existing value? */
 		if ((action == ENTER) && (item.data != NULL)) {
@@ -252,12 +301,16 @@ static inline int _compare_and_overwrite_entry(ENTRY item, ACTION action,
 				return 0;
 			}
 
-			free(htab->table[idx].entry.data);
-			htab->table[idx].entry.data = strdup(item.data);
-			if (!htab->table[idx].entry.data) {
-				__set_errno(ENOMEM);
-				*retval = NULL;
-				return 0;
+			/* Rewriting the same value leaves the table clean */
+			if (strcmp(htab->table[idx].entry.data, item.data)) {
+				free(htab->table[idx].entry.data);
+				htab->table[idx].entry.data = strdup(item.data);
+				if (!htab->table[idx].entry.data) {
+					__set_errno(ENOMEM);
+					*retval = NULL;
+					return 0;
+				}
+				htab->dirty = 1;
 			}
 		}
 		/* return found entry */
@@ -272,77 +325,33 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 	      struct hsearch_data *htab, int flag)
 {
 	unsigned int hval;
-	unsigned int count;
-	unsigned int len = strlen(item.key);
-	unsigned int idx;
+	unsigned int pos;
+	unsigned int step;
+	unsigned int idx = 0;
 	unsigned int first_deleted = 0;
 	int ret;
 
-	/* Compute an value for the given string. Perhaps use a better method. */
-	hval = len;
-	count = len;
-	while (count-- > 0) {
-		hval <<= 4;
-		hval += item.key[count];
-	}
-
-	/*
-	 * First hash function:
-	 * simply take the modul but prevent zero.
-	 */
-	hval %= htab->size;
-	if (hval == 0)
-		++hval;
-
-	/* The first index tried. */
-	idx = hval;
-
-	if (htab->table[idx].used) {
-		/*
-		 * Further action might be required according to the
-		 * action value.
-		 */
-		unsigned hval2;
-
-		if (htab->table[idx].used == -1
-		    && !first_deleted)
-			first_deleted = idx;
-
-		ret = _compare_and_overwrite_entry(item, action, retval, htab,
-			flag, hval, idx);
-		if (ret != -1)
-			return ret;
+	hval = hstr(item.key);
+	pos = hval & (htab->size - 1);
 
-		/*
-		 * Second hash function:
-		 * as suggested in [Knuth]
-		 */
-		hval2 = 1 + hval % (htab->size - 2);
-
-		do {
-			/*
-			 * Because SIZE is prime this guarantees to
-			 * step through all available indices.
-			 */
-			if (idx <= hval2)
-				idx = htab->size + idx - hval2;
-			else
-				idx -= hval2;
+	for (step = 1; step <= htab->size; ++step) {
+		idx = pos + 1;
 
-			/*
-			 * If we visited all entries leave the loop
-			 * unsuccessfully.
-			 */
-			if (idx == hval)
-				break;
+		if (!htab->table[idx].used)
+			break;
 
+		if (htab->table[idx].used == -1) {
+			if (!first_deleted)
+				first_deleted = idx;
+		} else {
 			/* If entry is found use it. */
-			ret = _compare_and_overwrite_entry(item, action, retval,
-				htab, flag, hval, idx);
+			ret = _compare_and_overwrite_entry(item, action,
+				retval, htab, flag, hval, idx);
 			if (ret != -1)
 				return ret;
 		}
-		while (htab->table[idx].used);
+
+		pos = (pos + step) & (htab->size - 1);
 	}
 
 	/* An empty bucket has been found. */
@@ -364,15 +373,26 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 		if (first_deleted)
 			idx = first_deleted;
 
-		htab->table[idx].used = hval;
 		htab->table[idx].entry.key = strdup(item.key);
 		htab->table[idx].entry.data = strdup(item.data);
 		if (!htab->table[idx].entry.key ||
 		    !htab->table[idx].entry.data) {
+			free((void *)htab->table[idx].entry.key);
+			free(htab->table[idx].entry.data);
+			htab->table[idx].entry.key = NULL;
+			htab->table[idx].entry.data = NULL;
 			__set_errno(ENOMEM);
 			*retval = NULL;
 			return 0;
 		}
+		htab->table[idx].used = 1;
+		htab->table[idx].hval = hval;
+
+		/* Keep the key index sorted */
+		pos = hsorted_pos(htab, item.key);
+		memmove(&htab->sorted[pos + 1], &htab->sorted[pos],
+			(htab->filled - pos) * sizeof(htab->sorted[0]));
+		htab->sorted[pos] = idx;
 
 		++htab->filled;
 
@@ -404,6 +424,8 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 			return 0;
 		}
 
+		htab->dirty = 1;
+
 		/* return new entry */
 		*retval = &htab->table[idx].entry;
 		return 1;
@@ -428,6 +450,14 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 static void _hdelete(const char *key, struct hsearch_data *htab, ENTRY *ep,
 	int idx)
 {
+	unsigned int pos;
+
+	/* drop it from the key index */
+	pos = hsorted_pos(htab, ep->key);
+	if (pos < htab->filled && htab->sorted[pos] == idx)
+		memmove(&htab->sorted[pos], &htab->sorted[pos + 1],
+			(htab->filled - pos - 1) * sizeof(htab->sorted[0]));
+
 	/* free used ENTRY */
 	debug("hdelete: DELETING key \"%s\"\n", key);
 	free((void *)ep->key);
@@ -473,6 +503,7 @@ int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
 	}
 
 	_hdelete(key, htab, ep, idx);
+	htab->dirty = 1;
 
 	return 1;
 }
@@ -520,14 +551,6 @@ int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
  *		bytes in the string will be '\0'-padded.
  */
 
-static int cmpkey(const void *p1, const void *p2)
-{
-	ENTRY *e1 = *(ENTRY **) p1;
-	ENTRY *e2 = *(ENTRY **) p2;
-
-	return (strcmp(e1->key, e2->key));
-}
-
 static int match_string(int flag, const char *str, const char *pat, void *priv)
 {
 	switch (flag & H_MATCH_METHOD) {
@@ -606,54 +629,39 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		"size = %zu\n", htab, htab->size, htab->filled, size);
 	/*
 	 * Pass 1:
-	 * search used entries,
+	 * walk the key index, so the list comes out sorted,
 	 * save addresses and compute total length
 	 */
-	for (i = 1, n = 0, totlen = 0; i <= htab->size; ++i) {
-
-		if (htab->table[i].used > 0) {
-			ENTRY *ep = &htab->table[i].entry;
-			int found = match_entry(ep, flag, argc, argv);
+	for (i = 0, n = 0, totlen = 0; i < htab->filled; ++i) {
+		ENTRY *ep = &htab->table[htab->sorted[i]].entry;
+		int found = match_entry(ep, flag, argc, argv);
 
-			if ((argc > 0) && (found == 0))
-				continue;
+		if ((argc > 0) && (found == 0))
+			continue;
 
-			if ((flag & H_HIDE_DOT) && ep->key[0] == '.')
-				continue;
+		if ((flag & H_HIDE_DOT) && ep->key[0] == '.')
+			continue;
 
-			list[n++] = ep;
+		list[n++] = ep;
 
-			totlen += strlen(ep->key) + 2;
+		totlen += strlen(ep->key) + 2;
 
-			if (sep == '\0') {
-				totlen += strlen(ep->data);
-			} else {	/* check if escapes are needed */
-				char *s = ep->data;
+		if (sep == '\0') {
+			totlen += strlen(ep->data);
+		} else {	/* check if escapes are needed */
+			char *s = ep->data;
 
-				while (*s) {
+			while (*s) {
+				++totlen;
+				/* add room for needed escape chars */
+				if ((*s == sep) || (*s == '\\'))
 					++totlen;
-					/* add room for needed escape chars */
-					if ((*s == sep) || (*s == '\\'))
-						++totlen;
-					++s;
-				}
+				++s;
 			}
-			totlen += 2;	/* for '=' and 'sep' char */
 		}
+		totlen += 2;	/* for '=' and 'sep' char */
 	}
 
-#ifdef DEBUG
-	/* Pass 1a: print unsorted list */
-	printf("Unsorted: n=%d\n", n);
-	for (i = 0; i < n; ++i) {
-		printf("\t%3d: %p ==> %-10s => %s\n",
-		       i, list[i], list[i]->key, list[i]->data);
-	}
-#endif
-
-	/* Sort list by keys */
-	qsort(list, n, sizeof(ENTRY *), cmpkey);
-
 	/* Check if the user supplied buffer size is sufficient */
 	if (size) {
 		if (size < totlen + 1) {	/* provided buffer too small */
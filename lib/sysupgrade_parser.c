@@ -6,6 +6,9 @@
 #ifdef CONFIG_CMD_NAND
 #include <nand.h>
 #endif
+#ifdef CONFIG_CMD_UBI
+#include <ubi_uboot.h>
+#endif
 #ifdef CONFIG_IPQ40XX
 #include <../board/qca/arm/common/fdt_info.h>
 #endif
@@ -29,62 +32,148 @@ static int tar_is_rootfs_name(const char *name) {
 		strstr(name, "squashfs") != NULL;
 }
 
-static sysupgrade_fw_parts parse_sysupgrade(void *address) {
-	sysupgrade_fw_parts parts;
-	uintptr_t base = (uintptr_t)address, pos, data;
-	int header_off = (memcmp((void *)(base + 257), "ustar", 5) == 0) ? 0 : 10;
-	int max_entries = 32, entry, i, j;
-	char *hdr;
-	unsigned long fsize, padded;
-	const uint32_t MAGIC_HSQS = 0x73717368;
-	uint8_t *sb;
-	u64 bytes_used;
-
-	memset(&parts, 0, sizeof(parts));
-
-	if (memcmp((void *)(base + header_off + 257), "ustar", 5) == 0 ||
-	    memcmp((void *)(base + 257), "ustar", 5) == 0) {
-		pos = base + header_off;
-
-		for (entry = 0; entry < max_entries; entry++) {
-			hdr = (char *)pos;
-
-			if (hdr[0] == 0)
-				break;
-
-			if (memcmp(hdr + 257, "ustar", 5) != 0)
-				break;
-
-			fsize = tar_parse_size(hdr + 124, 12);
-			data = pos + 512;
-			padded = (fsize + 511) & ~511UL;
-
-			if (fsize > 0 && !parts.kernel_data && tar_is_kernel_name(hdr)) {
-				parts.kernel_data = (const void *)data;
-				parts.kernel_size = fsize;
-			} else if (fsize > 0 && !parts.rootfs_data && tar_is_rootfs_name(hdr)) {
-				parts.rootfs_data = (const void *)data;
-				parts.rootfs_size = fsize;
-			}
+#define SYSUPGRADE_MAX_ENTRIES	32
+#define SYSUPGRADE_SCAN_MAX	(64 * 1024 * 1024)
+#define SYSUPGRADE_DETECT_LEN	(10 + 257 + 5)
+#define SQUASHFS_SB_LEN		48
+#define SQUASHFS_MAGIC		0x73717368	/* "hsqs" */
+
+enum {
+	SU_DETECT,
+	SU_TAR_HDR,
+	SU_TAR_DATA,
+	SU_RAW_SCAN,
+	SU_RAW_SB,
+	SU_DONE,
+};
+
+/* The image received by the failsafe server, parsed while it arrives */
+static sysupgrade_stream upload_stream;
+
+void sysupgrade_stream_init(sysupgrade_stream *s, const void *address) {
+	memset(s, 0, sizeof(*s));
+	s->base = (const u8 *)address;
+	s->state = SU_DETECT;
+}
 
-			pos = data + padded;
-		}
-	} else {
-		for (i = header_off; i < 64 * 1024 * 1024; i += 4) {
-			if (*(uint32_t *)(base + i) == MAGIC_HSQS) {
-				parts.kernel_data = (const void *)(base + header_off);
-				parts.kernel_size = i - header_off;
-				parts.rootfs_data = (const void *)(base + i);
-				sb = (uint8_t *)parts.rootfs_data;
-				bytes_used = 0;
-				for (j = 0; j < 8; j++)
-					bytes_used |= (u64)sb[40 + j] << (j * 8);
-				if (bytes_used > 0)
-					parts.rootfs_size = (size_t)bytes_used;
-				break;
+static void stream_tar_header(sysupgrade_stream *s) {
+	const char *hdr = (const char *)s->base + s->pos;
+	unsigned long fsize;
+
+	if (s->entries >= SYSUPGRADE_MAX_ENTRIES || hdr[0] == 0 ||
+	    memcmp(hdr + 257, "ustar", 5) != 0) {
+		s->state = SU_DONE;
+		return;
+	}
+
+	fsize = tar_parse_size(hdr + 124, 12);
+	s->entries++;
+	s->member = NULL;
+	if (fsize > 0 && !s->parts.kernel_data && tar_is_kernel_name(hdr)) {
+		s->parts.kernel_data = s->base + s->pos + 512;
+		s->parts.kernel_size = fsize;
+		s->member = &s->kernel_done;
+	} else if (fsize > 0 && !s->parts.rootfs_data && tar_is_rootfs_name(hdr)) {
+		s->parts.rootfs_data = s->base + s->pos + 512;
+		s->parts.rootfs_size = fsize;
+		s->member = &s->rootfs_done;
+	}
+
+	s->member_end = s->pos + 512 + fsize;
+	s->pos += 512 + ((fsize + 511) & ~511UL);
+	s->state = SU_TAR_DATA;
+}
+
+/*
+ * Account for the image bytes [0, @received) now sitting at the stream base
+ * and advance the parser over them. The data is never copied, only the tar
+ * member headers (or the squashfs magic of a plain kernel+rootfs image) are
+ * looked at, so this is cheap enough to run for every received packet.
+ */
+void sysupgrade_stream_feed(sysupgrade_stream *s, unsigned long received) {
+	const u8 *sb;
+	int j;
+
+	if (received <= s->received)
+		return;
+	s->received = received;
+
+	for (;;) {
+		switch (s->state) {
+		case SU_DETECT:
+			if (received < SYSUPGRADE_DETECT_LEN)
+				return;
+			s->header_off = (memcmp(s->base + 257, "ustar", 5) == 0) ? 0 : 10;
+			s->pos = s->header_off;
+			if (memcmp(s->base + s->header_off + 257, "ustar", 5) == 0 ||
+			    memcmp(s->base + 257, "ustar", 5) == 0)
+				s->state = SU_TAR_HDR;
+			else
+				s->state = SU_RAW_SCAN;
+			break;
+		case SU_TAR_HDR:
+			if (received < s->pos + 512)
+				return;
+			stream_tar_header(s);
+			break;
+		case SU_TAR_DATA:
+			if (received < s->member_end)
+				return;
+			if (s->member)
+				*s->member = 1;
+			s->state = SU_TAR_HDR;
+			break;
+		case SU_RAW_SCAN:
+			while (s->pos + 4 <= received) {
+				if (s->pos >= SYSUPGRADE_SCAN_MAX) {
+					s->state = SU_DONE;
+					return;
+				}
+				if (*(const uint32_t *)(s->base + s->pos) == SQUASHFS_MAGIC)
+					break;
+				s->pos += 4;
 			}
+			if (s->pos + 4 > received)
+				return;
+			s->parts.kernel_data = s->base + s->header_off;
+			s->parts.kernel_size = s->pos - s->header_off;
+			s->parts.rootfs_data = s->base + s->pos;
+			s->kernel_done = 1;
+			s->state = SU_RAW_SB;
+			break;
+		case SU_RAW_SB:
+			if (received < s->pos + SQUASHFS_SB_LEN)
+				return;
+			sb = s->base + s->pos;
+			s->bytes_used = 0;
+			for (j = 0; j < 8; j++)
+				s->bytes_used |= (u64)sb[40 + j] << (j * 8);
+			if (s->bytes_used > 0)
+				s->parts.rootfs_size = (size_t)s->bytes_used;
+			s->rootfs_done = 1;
+			s->state = SU_DONE;
+			break;
+		default:
+			return;
 		}
 	}
+}
+
+/*
+ * Close the stream and return what was found. Members which did not arrive
+ * completely are dropped.
+ */
+sysupgrade_fw_parts sysupgrade_stream_finish(sysupgrade_stream *s) {
+	sysupgrade_fw_parts parts = s->parts;
+
+	if (!s->kernel_done) {
+		parts.kernel_data = NULL;
+		parts.kernel_size = 0;
+	}
+	if (!s->rootfs_done) {
+		parts.rootfs_data = NULL;
+		parts.rootfs_size = 0;
+	}
 
 	sysupgrade_parts_valid(&parts) ?
 		printf("kernel %lu, rootfs %lu\n",
@@ -94,8 +183,39 @@ static sysupgrade_fw_parts parse_sysupgrade(void *address) {
 	return parts;
 }
 
+void sysupgrade_upload_begin(void *address) {
+	sysupgrade_stream_init(&upload_stream, address);
+	upload_stream.active = 1;
+}
+
+void sysupgrade_upload_data(unsigned long received) {
+	if (upload_stream.active)
+		sysupgrade_stream_feed(&upload_stream, received);
+}
+
+void sysupgrade_upload_end(unsigned long size) {
+	if (!upload_stream.active)
+		return;
+	sysupgrade_stream_feed(&upload_stream, size);
+	upload_stream.active = 0;
+	upload_stream.complete = 1;
+}
+
+void sysupgrade_upload_abort(void) {
+	upload_stream.active = 0;
+	upload_stream.complete = 0;
+}
+
 sysupgrade_fw_parts parse_sysupgrade_firmware(void *address) {
-	return parse_sysupgrade(address);
+	sysupgrade_stream s;
+
+	/* Already parsed while it was being uploaded */
+	if (upload_stream.complete && upload_stream.base == address)
+		return sysupgrade_stream_finish(&upload_stream);
+
+	sysupgrade_stream_init(&s, address);
+	sysupgrade_stream_feed(&s, ~0UL - (unsigned long)address);
+	return sysupgrade_stream_finish(&s);
 }
 
 #ifdef CONFIG_CMD_UBI
@@ -134,53 +254,76 @@ int sysupgrade_ubi_init(void) {
 	return run_command(cmd, 0);
 }
 
-static int ubi_write_volume(const char *name, const void *data, size_t size, int required) {
-	char buf[256];
-	char rm_cmd[64];
+static int ubi_write_volume(const char *name, const char *backup,
+			    const void *data, size_t size) {
+	char *vols[2] = { (char *)name, (char *)backup };
 
-	snprintf(rm_cmd, sizeof(rm_cmd), "ubi remove %s", name);
-	run_command(rm_cmd, 0);
-
-	snprintf(buf, sizeof(buf),
-		 "ubi create %s 0x%llx && "
-		 "ubi write 0x%lx %s 0x%llx",
-		 name, (u64)size,
-		 (unsigned long)data, name,
-		 (u64)size);
-
-	if (run_command(buf, 0) != 0) {
-		required ? printf("%s write failed\n", name) :
-			   printf("%s skip\n", name);
+	/*
+	 * Primary and backup bank are written in one pass over the data,
+	 * a backup that cannot be written only costs the backup.
+	 */
+	if (ubi_volume_write_multi(vols, backup ? 2 : 1, data, size) != 0) {
+		printf("%s write failed\n", name);
 		return -1;
 	}
 	return 0;
 }
 
 int sysupgrade_write_ubi_volumes(sysupgrade_fw_parts *parts, int backup_enabled) {
+	int has_kernel = parts->kernel_data && parts->kernel_size > 0;
+	int has_rootfs = parts->rootfs_data && parts->rootfs_size > 0;
+	const char *kernel_1 = NULL, *rootfs_1 = NULL;
+
 	if (sysupgrade_ubi_init() != 0) {
 		printf("UBI init failed\n");
 		return -1;
 	}
 
-	run_command("ubi part fs", 0);
-	run_command("ubi remove rootfs_data", 0);
-
-	if (parts->kernel_data && parts->kernel_size > 0 &&
-	    ubi_write_volume("kernel", parts->kernel_data, parts->kernel_size, 1) != 0)
+	if (ubi_part("fs", NULL) != 0) {
+		printf("UBI attach failed\n");
 		return -1;
-
-	if (parts->rootfs_data && parts->rootfs_size > 0 &&
-	    ubi_write_volume("rootfs", parts->rootfs_data, parts->rootfs_size, 1) != 0)
+	}
+	ubi_volume_remove("rootfs_data");
+
+	/*
+	 * Lay out the primary volumes first so that they always get the
+	 * space, volumes which already have the right size are kept.
+	 */
+	if (has_kernel && ubi_volume_prepare("kernel", parts->kernel_size) != 0) {
+		printf("kernel write failed\n");
+		return -1;
+	}
+	if (has_rootfs && ubi_volume_prepare("rootfs", parts->rootfs_size) != 0) {
+		printf("rootfs write failed\n");
 		return -1;
+	}
 
 	if (backup_enabled) {
-		if (parts->kernel_data && parts->kernel_size > 0)
-			ubi_write_volume("kernel_1", parts->kernel_data, parts->kernel_size, 0);
-		if (parts->rootfs_data && parts->rootfs_size > 0)
-			ubi_write_volume("rootfs_1", parts->rootfs_data, parts->rootfs_size, 0);
+		if (has_kernel) {
+			if (ubi_volume_prepare("kernel_1", parts->kernel_size) == 0)
+				kernel_1 = "kernel_1";
+			else
+				printf("kernel_1 skip\n");
+		}
+		if (has_rootfs) {
+			if (ubi_volume_prepare("rootfs_1", parts->rootfs_size) == 0)
+				rootfs_1 = "rootfs_1";
+			else
+				printf("rootfs_1 skip\n");
+		}
 	}
 
-	run_command("ubi create rootfs_data", 0);
+	if (has_kernel &&
+	    ubi_write_volume("kernel", kernel_1, parts->kernel_data,
+			     parts->kernel_size) != 0)
+		return -1;
+
+	if (has_rootfs &&
+	    ubi_write_volume("rootfs", rootfs_1, parts->rootfs_data,
+			     parts->rootfs_size) != 0)
+		return -1;
+
+	ubi_volume_prepare("rootfs_data", 0);
 
 	return 0;
 }
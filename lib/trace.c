@@ -5,6 +5,7 @@
  */
 
 #include <common.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <trace.h>
 #include <asm/io.h>
@@ -151,6 +152,10 @@ int trace_list_functions(void *buff, int buff_size, unsigned int *needed)
 	int func;
 	int upto;
 
+	if (!trace_inited) {
+		*needed = 0;
+		return -1;
+	}
 	end = buff ? buff + buff_size : NULL;
 
 	/* Place some header information */
@@ -195,6 +200,10 @@ int trace_list_calls(void *buff, int buff_size, unsigned *needed)
 	int rec, upto;
 	int count;
 
+	if (!trace_inited) {
+		*needed = 0;
+		return -1;
+	}
 	end = buff ? buff + buff_size : NULL;
 
 	/* Place some header information */
@@ -265,6 +274,152 @@ void trace_print_stats(void)
 	puts(" calls not traced due to depth\n");
 }
 
+/* Time spent in one function, gathered from the call list */
+struct trace_func_time {
+	uint32_t func;		/* Function number plus one, 0 if unused */
+	uint32_t calls;		/* Number of completed calls */
+	uint32_t total_us;	/* Time including callees */
+	uint32_t self_us;	/* Time excluding callees */
+};
+
+enum {
+	TRACE_TOP_SLOTS	= 1024,	/* Distinct functions we can time */
+	TRACE_TOP_DEPTH	= 256,	/* Deepest call stack we can follow */
+};
+
+/* An open call while walking the call list */
+struct trace_frame {
+	uint32_t func;		/* Function number */
+	uint32_t start;		/* Entry timestamp */
+	uint32_t child_us;	/* Time spent in callees so far */
+};
+
+static struct trace_func_time *find_func_time(struct trace_func_time *slots,
+					      uint32_t func)
+{
+	uint32_t i, slot = func % TRACE_TOP_SLOTS;
+
+	for (i = 0; i < TRACE_TOP_SLOTS; i++) {
+		struct trace_func_time *ft = &slots[slot];
+
+		if (ft->func == func + 1)
+			return ft;
+		if (!ft->func) {
+			ft->func = func + 1;
+			return ft;
+		}
+		slot = (slot + 1) % TRACE_TOP_SLOTS;
+	}
+
+	return NULL;
+}
+
+static ulong func_num_to_addr(uint32_t func)
+{
+	ulong base;
+
+#ifdef CONFIG_SANDBOX
+	base = (ulong)&_init;
+#else
+	base = gd->flags & GD_FLG_RELOC ? gd->relocaddr : CONFIG_SYS_TEXT_BASE;
+#endif
+	return base + func * FUNC_SITE_SIZE;
+}
+
+/**
+ * Print the functions which took the most time
+ *
+ * The call list is replayed with a shadow stack, pairing each exit with
+ * its entry. Exits without a traced entry (calls made before tracing
+ * started, or deeper than the depth limit) are skipped.
+ *
+ * @param count		Number of functions to print
+ */
+void trace_print_top(int count)
+{
+	struct trace_frame *stack;
+	struct trace_func_time *slots, *ft;
+	ulong rec, nrecs, lost = 0;
+	int sp = 0, i, j;
+
+	if (!trace_inited || count <= 0)
+		return;
+
+	slots = calloc(TRACE_TOP_SLOTS, sizeof(*slots));
+	stack = malloc(TRACE_TOP_DEPTH * sizeof(*stack));
+	if (!slots || !stack) {
+		puts("trace: out of memory\n");
+		goto out;
+	}
+
+	nrecs = min(hdr->ftrace_count, hdr->ftrace_size);
+	for (rec = 0; rec < nrecs; rec++) {
+		struct trace_call *call = &hdr->ftrace[rec];
+		uint32_t now = call->flags & FUNCF_TIMESTAMP_MASK;
+		uint32_t elapsed;
+
+		if (TRACE_CALL_TYPE(call) == FUNCF_ENTRY) {
+			if (sp == TRACE_TOP_DEPTH) {
+				lost++;
+				continue;
+			}
+			stack[sp].func = call->func;
+			stack[sp].start = now;
+			stack[sp].child_us = 0;
+			sp++;
+			continue;
+		}
+		if (TRACE_CALL_TYPE(call) != FUNCF_EXIT)
+			continue;
+
+		/* Drop entries whose exit was not recorded */
+		for (i = sp - 1; i >= 0; i--) {
+			if (stack[i].func == call->func)
+				break;
+		}
+		if (i < 0)
+			continue;
+		sp = i;
+
+		elapsed = (now - stack[sp].start) & FUNCF_TIMESTAMP_MASK;
+		if (sp)
+			stack[sp - 1].child_us += elapsed;
+		ft = find_func_time(slots, call->func);
+		if (!ft) {
+			lost++;
+			continue;
+		}
+		ft->calls++;
+		ft->total_us += elapsed;
+		if (elapsed > stack[sp].child_us)
+			ft->self_us += elapsed - stack[sp].child_us;
+	}
+
+	printf("\n%12s %12s %10s  %-8s\n", "Self us", "Total us", "Calls",
+	       "Address");
+	for (i = 0; i < count; i++) {
+		struct trace_func_time *best = NULL;
+
+		for (j = 0; j < TRACE_TOP_SLOTS; j++) {
+			ft = &slots[j];
+			if (ft->calls && (!best || ft->self_us > best->self_us))
+				best = ft;
+		}
+		if (!best)
+			break;
+		printf("%12u %12u %10u  %08lx\n", best->self_us,
+		       best->total_us, best->calls,
+		       func_num_to_addr(best->func - 1));
+		best->calls = 0;
+	}
+	if (lost)
+		printf("(%lu calls not timed: out of slots or too deep)\n",
+		       lost);
+out:
+	free(stack);
+	free(slots);
+}
+
 void __attribute__((no_instrument_function)) trace_set_enabled(int enabled)
 {
 	trace_enabled = enabled != 0;
@@ -17,13 +17,26 @@
 static struct dhcpd_lease dhcpd_leases[MAX_LEASES];
 struct dhcpd_svr_cfg dhcpd_svr_cfg;
 
+/* Leases by client MAC address, chained through lease->next */
+static struct dhcpd_lease *dhcpd_mac_hash[DHCPD_HASH_SIZE];
+/* Unused leases, chained through lease->next */
+static struct dhcpd_lease *dhcpd_free_leases;
+
+/*
+ * Pool addresses are tracked by their offset from start_ip: a bit set in
+ * dhcpd_ip_map means the address is leased, to dhcpd_ip_owner[offset].
+ */
+static uint32_t dhcpd_ip_map[(MAX_LEASES + 31) / 32];
+static struct dhcpd_lease *dhcpd_ip_owner[MAX_LEASES];
+static unsigned int dhcpd_pool_size;
+/* Offset where the search for a free address continues */
+static unsigned int dhcpd_next_free;
+
 static char dhcpd_nak_msg_buffer[256];
 
 static dhcpd_state_t dhcpd_state = DHCPD_STATE_STOPPED;
 static rxhand_f *original_udp_handler = NULL;
 
-/* DHCP magic cookie as defined in RFC 2131 */
-
 /* DHCP magic cookie as defined in RFC 2131 */
 static const uint8_t dhcp_magic_cookie[4] = { 99, 130, 83, 99 };
 
@@ -37,15 +50,54 @@ static bool dhcpd_mac_equal(const uint8_t *a, const uint8_t *b) {
 	return memcmp(a, b, 6) == 0;
 }
 
+/**
+ * dhcpd_mac_hash_idx - Hash a MAC address to a dhcpd_mac_hash bucket
+ * @mac: Client MAC address
+ * Return: Bucket index
+ *
+ * Units from one batch share the OUI and usually differ in the last
+ * byte or two only, so every byte is mixed into the result.
+ */
+static unsigned int dhcpd_mac_hash_idx(const uint8_t *mac) {
+	uint32_t h = 0;
+
+	for (int i = 0; i < 6; i++)
+		h = (h ^ mac[i]) * 0x01000193;
+	h ^= h >> 15;
+
+	return h & (DHCPD_HASH_SIZE - 1);
+}
+
+/**
+ * dhcpd_lease_expired - Check whether a lease has run out
+ * @lease: Lease to check
+ * Return: true if the lease time has passed
+ */
+static bool dhcpd_lease_expired(const struct dhcpd_lease *lease) {
+	return get_timer(lease->lease_start) >= lease->lease_time;
+}
+
+/**
+ * dhcpd_renew_lease - Restart the lease time of a lease
+ * @lease: Lease to renew
+ * @secs: New lease time in seconds
+ */
+static void dhcpd_renew_lease(struct dhcpd_lease *lease, unsigned long secs) {
+	lease->lease_start = get_timer(0);
+	lease->lease_time = secs * CONFIG_SYS_HZ;
+}
+
 /**
  * dhcpd_find_lease - Find DHCP lease by MAC address
  * @mac: Client MAC address to search for
  * Return: Pointer to lease if found, NULL otherwise
  */
 static struct dhcpd_lease *dhcpd_find_lease(const uint8_t *mac) {
-	for (int i = 0; i < MAX_LEASES; i++) {
-		if (dhcpd_leases[i].used && dhcpd_mac_equal(dhcpd_leases[i].mac_addr, mac))
-			return &dhcpd_leases[i];
+	struct dhcpd_lease *lease;
+
+	for (lease = dhcpd_mac_hash[dhcpd_mac_hash_idx(mac)]; lease; lease = lease->next) {
+		if (dhcpd_mac_equal(lease->mac_addr, mac))
+			return lease;
 	}
 	return NULL;
 }
@@ -62,32 +114,108 @@ static bool dhcpd_ip_in_pool(uint32_t ip_host) {
 }
 
 /**
- * dhcpd_ip_is_allocated - Check if IP address is already leased to any client
+ * dhcpd_ip_owner_of - Find the lease holding a pool address
  * @ip_host: IP address in host byte order
- * Return: true if IP is already allocated
+ * Return: Pointer to lease if the address is leased, NULL otherwise
  */
-static bool dhcpd_ip_is_allocated(uint32_t ip_host) {
-	for (int i = 0; i < MAX_LEASES; i++) {
-		if (dhcpd_leases[i].used && dhcpd_leases[i].ip_addr.s_addr == htonl(ip_host)) {
-			return true;
-		}
-	}
-	return false;
+static struct dhcpd_lease *dhcpd_ip_owner_of(uint32_t ip_host) {
+	uint32_t off;
+
+	if (!dhcpd_ip_in_pool(ip_host))
+		return NULL;
+
+	off = ip_host - ntohl(dhcpd_svr_cfg.start_ip.s_addr);
+	if (!(dhcpd_ip_map[off / 32] & (1U << (off % 32))))
+		return NULL;
+
+	return dhcpd_ip_owner[off];
 }
 
 /**
- * dhcpd_ip_allocated_to_mac - Check if IP is allocated to specific MAC address
+ * dhcpd_ip_take - Mark a pool address as leased
+ * @lease: Lease which gets the address, its ip_addr is updated
  * @ip_host: IP address in host byte order
- * @mac: MAC address to check
- * Return: true if IP is allocated to this specific MAC
  */
-static bool dhcpd_ip_allocated_to_mac(uint32_t ip_host, const uint8_t *mac) {
+static void dhcpd_ip_take(struct dhcpd_lease *lease, uint32_t ip_host) {
+	uint32_t off = ip_host - ntohl(dhcpd_svr_cfg.start_ip.s_addr);
+
+	lease->ip_addr.s_addr = htonl(ip_host);
+	if (!dhcpd_ip_in_pool(ip_host))
+		return;
+
+	dhcpd_ip_map[off / 32] |= 1U << (off % 32);
+	dhcpd_ip_owner[off] = lease;
+}
+
+/**
+ * dhcpd_ip_put - Return the address of a lease to the pool
+ * @lease: Lease giving up its address
+ */
+static void dhcpd_ip_put(struct dhcpd_lease *lease) {
+	uint32_t ip_host = ntohl(lease->ip_addr.s_addr);
+	uint32_t off = ip_host - ntohl(dhcpd_svr_cfg.start_ip.s_addr);
+
+	if (dhcpd_ip_owner_of(ip_host) != lease)
+		return;
+
+	dhcpd_ip_map[off / 32] &= ~(1U << (off % 32));
+	dhcpd_ip_owner[off] = NULL;
+}
+
+/**
+ * dhcpd_free_lease - Drop a lease and release its address
+ * @lease: Lease to drop
+ */
+static void dhcpd_free_lease(struct dhcpd_lease *lease) {
+	struct dhcpd_lease **pp = &dhcpd_mac_hash[dhcpd_mac_hash_idx(lease->mac_addr)];
+
+	while (*pp && *pp != lease)
+		pp = &(*pp)->next;
+	if (*pp)
+		*pp = lease->next;
+
+	dhcpd_ip_put(lease);
+	memset(lease, 0, sizeof(*lease));
+	lease->next = dhcpd_free_leases;
+	dhcpd_free_leases = lease;
+}
+
+/**
+ * dhcpd_expire_leases - Drop all leases whose time has run out
+ * Return: Number of leases dropped
+ *
+ * Only called when the lease table or the pool is exhausted.
+ */
+static int dhcpd_expire_leases(void) {
+	int count = 0;
+
 	for (int i = 0; i < MAX_LEASES; i++) {
-		if (dhcpd_leases[i].used && dhcpd_leases[i].ip_addr.s_addr == htonl(ip_host) && dhcpd_mac_equal(dhcpd_leases[i].mac_addr, mac)) {
-			return true;
+		if (dhcpd_leases[i].used && dhcpd_lease_expired(&dhcpd_leases[i])) {
+			dhcpd_free_lease(&dhcpd_leases[i]);
+			count++;
 		}
 	}
-	return false;
+	return count;
+}
+
+/**
+ * dhcpd_reset_leases - Empty the lease table
+ */
+static void dhcpd_reset_leases(void) {
+	memset(dhcpd_leases, 0, sizeof(dhcpd_leases));
+	memset(dhcpd_mac_hash, 0, sizeof(dhcpd_mac_hash));
+	memset(dhcpd_ip_map, 0, sizeof(dhcpd_ip_map));
+	memset(dhcpd_ip_owner, 0, sizeof(dhcpd_ip_owner));
+	dhcpd_next_free = 0;
+
+	dhcpd_free_leases = NULL;
+	for (int i = MAX_LEASES - 1; i >= 0; i--) {
+		dhcpd_leases[i].next = dhcpd_free_leases;
+		dhcpd_free_leases = &dhcpd_leases[i];
+	}
+
+	dhcpd_pool_size = ntohl(dhcpd_svr_cfg.end_ip.s_addr) -
+			  ntohl(dhcpd_svr_cfg.start_ip.s_addr) + 1;
 }
 
 /**
@@ -104,107 +232,111 @@ static int dhcpd_validate_config(const struct dhcpd_svr_cfg *cfg) {
 		return ERR_CONFIG;
 	}
 
+	if (ntohl(cfg->end_ip.s_addr) < ntohl(cfg->start_ip.s_addr) ||
+	    ntohl(cfg->end_ip.s_addr) - ntohl(cfg->start_ip.s_addr) >= MAX_LEASES) {
+		return ERR_CONFIG;
+	}
+
 	return SUCCESS;
 }
 
 /**
  * dhcpd_create_lease - Create a new DHCP lease
  * @mac: Client MAC address
- * @ip: IP address to assign
- * @index: Index in dhcpd_leases array to use
- * Return: SUCCESS on success, error code on failure
+ * @ip_host: IP address to assign, in host byte order
+ * @secs: Lease time in seconds
+ * Return: Pointer to the new lease, NULL if the table is full
  */
-static int dhcpd_create_lease(const uint8_t *mac, struct in_addr ip, int index) {
-	if (!mac || index < 0 || index >= MAX_LEASES) {
-		return ERR_INVALID_PARAM;
-	}
+static struct dhcpd_lease *dhcpd_create_lease(const uint8_t *mac, uint32_t ip_host, unsigned long secs) {
+	struct dhcpd_lease *lease;
+	unsigned int h;
 
-	dhcpd_leases[index].used = true;
-	memcpy(dhcpd_leases[index].mac_addr, mac, 6);
-	dhcpd_leases[index].ip_addr = ip;
-	dhcpd_leases[index].lease_start = get_timer(0);
-	dhcpd_leases[index].lease_time = 3600 * CONFIG_SYS_HZ; /* 1 hour */
+	if (!dhcpd_free_leases)
+		dhcpd_expire_leases();
 
-	return SUCCESS;
+	lease = dhcpd_free_leases;
+	if (!lease)
+		return NULL;
+	dhcpd_free_leases = lease->next;
+
+	lease->used = true;
+	memcpy(lease->mac_addr, mac, 6);
+	dhcpd_ip_take(lease, ip_host);
+	dhcpd_renew_lease(lease, secs);
+
+	h = dhcpd_mac_hash_idx(mac);
+	lease->next = dhcpd_mac_hash[h];
+	dhcpd_mac_hash[h] = lease;
+
+	return lease;
 }
 
 /**
- * dhcpd_get_available_lease_slot - Find an available slot in the leases array
- * Return: Index of available slot, or -1 if no slots available
+ * dhcpd_find_free_ip - Find an unleased pool address
+ * @ip_host: Output parameter for the address, in host byte order
+ * Return: SUCCESS if found, ERR_SERVER_FULL otherwise
+ *
+ * Scans the allocation bitmap a word at a time, starting after the last
+ * address handed out, so consecutive clients get consecutive addresses.
  */
-static int dhcpd_get_available_lease_slot(void) {
-	for (int i = 0; i < MAX_LEASES; i++) {
-		if (!dhcpd_leases[i].used) {
-			return i;
+static int dhcpd_find_free_ip(uint32_t *ip_host) {
+	unsigned int words = (dhcpd_pool_size + 31) / 32;
+	unsigned int off = dhcpd_next_free;
+
+	for (unsigned int n = 0; n <= words; n++) {
+		unsigned int w = off / 32;
+		uint32_t used = dhcpd_ip_map[w] | ((1U << (off % 32)) - 1);
+
+		if (w == words - 1 && dhcpd_pool_size % 32)
+			used |= ~0U << (dhcpd_pool_size % 32);
+
+		if (used != ~0U) {
+			off = w * 32 + ffz(used);
+			dhcpd_next_free = (off + 1) % dhcpd_pool_size;
+			*ip_host = ntohl(dhcpd_svr_cfg.start_ip.s_addr) + off;
+			return SUCCESS;
 		}
+
+		off = (w + 1 < words) ? (w + 1) * 32 : 0;
 	}
-	return -1;
+
+	return ERR_SERVER_FULL;
 }
 
 /**
- * dhcpd_try_allocate_ip - Allocate IP and create lease
+ * dhcpd_alloc_ip - Find or create the lease of a client
  * @mac: Client MAC address
- * @try_ip: IP address to allocate
  * @allocated_ip: Output parameter for allocated IP
+ * @secs: Lease time in seconds for a new lease
  * Return: SUCCESS on success, error code on failure
  */
-static int dhcpd_try_allocate_ip(const uint8_t *mac, uint32_t try_ip, struct in_addr *allocated_ip) {
-	int lease_idx = dhcpd_get_available_lease_slot();
-	if (lease_idx >= 0) {
-		struct in_addr ip_addr;
-		ip_addr.s_addr = htonl(try_ip);
-		dhcpd_create_lease(mac, ip_addr, lease_idx);
-		*allocated_ip = dhcpd_leases[lease_idx].ip_addr;
+static int dhcpd_alloc_ip(const uint8_t *mac, struct in_addr *allocated_ip, unsigned long secs) {
+	struct dhcpd_lease *lease;
+	uint32_t ip_host;
+
+	lease = dhcpd_find_lease(mac);
+	if (lease) {
+		/* An offer does not cut short a lease the client already holds */
+		if (secs * CONFIG_SYS_HZ >= lease->lease_time || dhcpd_lease_expired(lease))
+			dhcpd_renew_lease(lease, secs);
+		*allocated_ip = lease->ip_addr;
 		return SUCCESS;
 	}
-	allocated_ip->s_addr = 0;
-	return ERR_SERVER_FULL;
-}
 
-static int dhcpd_alloc_ip(const uint8_t *mac, struct in_addr *allocated_ip) {
-    uint32_t start = ntohl(dhcpd_svr_cfg.start_ip.s_addr);
-    uint32_t end = ntohl(dhcpd_svr_cfg.end_ip.s_addr);
-
-    for (int i = 0; i < MAX_LEASES; i++) {
-        if (dhcpd_leases[i].used && dhcpd_mac_equal(dhcpd_leases[i].mac_addr, mac)) {
-            dhcpd_leases[i].lease_start = get_timer(0);
-            *allocated_ip = dhcpd_leases[i].ip_addr;
-            return SUCCESS;
-        }
-    }
-
-    uint32_t total_ips = end - start + 1;
-
-    int max_attempts = total_ips < 100 ? total_ips : 100;
-    for (int attempt = 0; attempt < max_attempts; attempt++) {
-        uint32_t mac_hash = 0;
-        for (int i = 0; i < 6; i++) {
-            mac_hash = mac_hash * 31 + mac[i];
-        }
-        uint32_t seed = mac_hash + get_timer(0) + attempt;
-        uint32_t random_offset = seed % (end - start + 1);
-        uint32_t random_ip = start + random_offset;
-        if (!dhcpd_ip_is_allocated(random_ip)) {
-            return dhcpd_try_allocate_ip(mac, random_ip, allocated_ip);
-        }
-    }
-
-    /* If random allocation fails, fall back to linear search */
-    uint32_t current_ip = start;
-    int total_ips_in_pool = end - start + 1;
-    int count = 0;
-
-    while (count < total_ips_in_pool) {
-        if (!dhcpd_ip_is_allocated(current_ip)) {
-            return dhcpd_try_allocate_ip(mac, current_ip, allocated_ip);
-        }
-
-        current_ip = (current_ip < end) ? current_ip + 1 : start;
-        count++;
-    }
-
-    allocated_ip->s_addr = 0;
-    return ERR_SERVER_FULL;
+	if (dhcpd_find_free_ip(&ip_host) != SUCCESS &&
+	    (!dhcpd_expire_leases() || dhcpd_find_free_ip(&ip_host) != SUCCESS)) {
+		allocated_ip->s_addr = 0;
+		return ERR_SERVER_FULL;
+	}
+
+	lease = dhcpd_create_lease(mac, ip_host, secs);
+	if (!lease) {
+		allocated_ip->s_addr = 0;
+		return ERR_SERVER_FULL;
+	}
+
+	*allocated_ip = lease->ip_addr;
+	return SUCCESS;
 }
 
 /**
@@ -366,33 +498,38 @@ static int dhcpd_validate_request(const uint8_t *client_mac, struct in_addr req_
  * Return: SUCCESS on success, error code on failure
  */
 static int dhcpd_process_lease(const uint8_t *client_mac, struct in_addr req_ip, struct in_addr *processed_ip) {
-	struct dhcpd_lease *lease;
+	struct dhcpd_lease *lease, *owner;
 	uint32_t ip_host = ntohl(req_ip.s_addr);
+	unsigned long secs = dhcpd_svr_cfg.lease_time;
 
 	if (!client_mac || !processed_ip) {
 		return ERR_INVALID_PARAM;
 	}
 
 	lease = dhcpd_find_lease(client_mac);
+	owner = dhcpd_ip_owner_of(ip_host);
 
-	if (dhcpd_ip_is_allocated(ip_host) && !dhcpd_ip_allocated_to_mac(ip_host, client_mac)) {
-		return dhcpd_alloc_ip(client_mac, processed_ip);
+	if (owner && owner != lease) {
+		if (!dhcpd_lease_expired(owner))
+			return dhcpd_alloc_ip(client_mac, processed_ip, secs);
+		/* The previous holder let it run out, hand it over */
+		dhcpd_free_lease(owner);
 	}
 
+	*processed_ip = req_ip;
+
 	if (lease) {
-		lease->ip_addr = req_ip;
-		lease->lease_start = get_timer(0);
-		lease->lease_time = 3600 * CONFIG_SYS_HZ; /* 1 hour */
-		*processed_ip = req_ip;
+		if (owner != lease) {
+			dhcpd_ip_put(lease);
+			dhcpd_ip_take(lease, ip_host);
+		}
+		dhcpd_renew_lease(lease, secs);
 		return SUCCESS;
 	}
 
-	int lease_idx = dhcpd_get_available_lease_slot();
-	*processed_ip = req_ip;
-	if (lease_idx < 0)
+	if (!dhcpd_create_lease(client_mac, ip_host, secs))
 		return ERR_SERVER_FULL;
 
-	dhcpd_create_lease(client_mac, req_ip, lease_idx);
 	return SUCCESS;
 }
 
@@ -544,7 +681,7 @@ static int dhcpd_send_reply(const struct dhcpd_pkt *req, unsigned int req_len, u
 			return ERR_BUFFER_OVERFLOW;
 		opt = dhcpd_opt_add_inaddr(opt, OPTION_DNS_SERVER, dns);
 
-		lease = htonl(3600); /* 1 hour */
+		lease = htonl(dhcpd_svr_cfg.lease_time);
 		if (opt + 6 > opt_end)
 			return ERR_BUFFER_OVERFLOW;
 		opt = dhcpd_opt_add_u32(opt, OPTION_LEASE_TIME, lease);
@@ -594,7 +731,7 @@ static int dhcpd_handle_request(const struct dhcpd_pkt *bp, unsigned int len) {
 	}
 
 	if (dhcpd_parse_req_ip(bp, len, &req_ip) != SUCCESS) {
-		ret = dhcpd_alloc_ip(bp->chaddr, &yiaddr);
+		ret = dhcpd_alloc_ip(bp->chaddr, &yiaddr, dhcpd_svr_cfg.lease_time);
 		if (ret != SUCCESS) {
 			return ret;
 		}
@@ -631,28 +768,16 @@ send_nak:
  * Return: SUCCESS on success, error code on failure
  */
 static int dhcpd_handle_discover(const uint8_t *client_mac, struct in_addr *yiaddr) {
-	struct dhcpd_lease *lease;
-	uint32_t ip_host;
 	if (!client_mac || !yiaddr) {
 		return ERR_INVALID_PARAM;
 	}
 
-	lease = dhcpd_find_lease(client_mac);
-
-	if (lease) {
-		ip_host = ntohl(lease->ip_addr.s_addr);
-
-		if (!dhcpd_ip_is_allocated(ip_host) || dhcpd_ip_allocated_to_mac(ip_host, client_mac)) {
-			*yiaddr = lease->ip_addr;
-			return SUCCESS;
-		} else {
-			/* IP has been taken by another client, reallocate */
-			lease->used = false;
-			memset(lease->mac_addr, 0, 6);
-		}
-	}
-
-	return dhcpd_alloc_ip(client_mac, yiaddr);
+	/*
+	 * A known client gets its address again. A new one only holds the
+	 * offered address for DHCPD_OFFER_TIME, so clients which never send
+	 * a REQUEST do not drain the pool.
+	 */
+	return dhcpd_alloc_ip(client_mac, yiaddr, DHCPD_OFFER_TIME);
 }
 
 /**
@@ -728,7 +853,7 @@ int dhcpd_set_config(struct dhcpd_svr_cfg *cfg) {
  */
 int dhcpd_init_server(void) {
 	dhcpd_ip_settings();
-	memset(dhcpd_leases, 0, sizeof(dhcpd_leases));
+	dhcpd_reset_leases();
 
 	original_udp_handler = net_get_udp_handler();
 
@@ -854,6 +979,17 @@ void dhcpd_ip_settings(void) {
 	char *env_ip = getenv("ipaddr");
 	char *env_netmask = getenv("netmask");
 	char *env_gateway = getenv("gatewayip");
+	unsigned long pool_size = getenv_ulong("dhcpd_pool_size", 10, DHCPD_DEF_POOL_SIZE);
+	unsigned long lease_time = getenv_ulong("dhcpd_lease_time", 10, DHCPD_DEF_LEASE_TIME);
+
+	if (pool_size == 0)
+		pool_size = DHCPD_DEF_POOL_SIZE;
+	if (pool_size > MAX_LEASES)
+		pool_size = MAX_LEASES;
+	if (lease_time == 0)
+		lease_time = DHCPD_DEF_LEASE_TIME;
+	if (lease_time > DHCPD_MAX_LEASE_TIME)
+		lease_time = DHCPD_MAX_LEASE_TIME;
 
 	if (env_ip == NULL || strcmp(env_ip, "192.168.1.1") != 0) {
 		setenv("ipaddr", "192.168.1.1");
@@ -881,7 +1017,7 @@ void dhcpd_ip_settings(void) {
 	uint32_t network_addr = ip_addr_int & netmask_int;
 	uint32_t broadcast_addr = network_addr | (~netmask_int);
 	uint32_t start_ip = ip_addr_int + 1;
-	uint32_t end_ip = ip_addr_int + 100;
+	uint32_t end_ip = ip_addr_int + pool_size;
 
 	if (start_ip <= network_addr) start_ip = network_addr + 1;
 	if (end_ip >= broadcast_addr) end_ip = broadcast_addr - 1;
@@ -890,10 +1026,13 @@ void dhcpd_ip_settings(void) {
 		start_ip = network_addr + 1;
 		end_ip = (start_ip + 10 < broadcast_addr) ? start_ip + 10 : broadcast_addr - 1;
 	}
+	if (end_ip - start_ip >= MAX_LEASES)
+		end_ip = start_ip + MAX_LEASES - 1;
 
 	dhcpd_svr_cfg.start_ip.s_addr = htonl(start_ip);
 	dhcpd_svr_cfg.end_ip.s_addr = htonl(end_ip);
 	dhcpd_svr_cfg.netmask = netmask_addr;
+	dhcpd_svr_cfg.lease_time = lease_time;
 
 	dhcpd_svr_cfg.gateway = (env_gateway != NULL) ? string_to_ip(env_gateway) : server_addr;
 
@@ -1023,5 +1162,7 @@ U_BOOT_CMD(
 	"  Start DHCP server for IP address assignment\n"
 	"  -nb: Non-blocking mode (returns immediately)\n"
 	"Environment variables used:\n"
-	"  ipaddr, netmask, gatewayip (optional)"
+	"  ipaddr, netmask, gatewayip (optional)\n"
+	"  dhcpd_pool_size: number of addresses handed out (default 100)\n"
+	"  dhcpd_lease_time: lease time in seconds (default 3600, max 604800)"
 );
\ No newline at end of file
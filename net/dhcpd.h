@@ -50,8 +50,23 @@
 #define HLEN_ETHER		6
 #define DHCP_FLAG_BROADCAST	0x8000
 
-/* Maximum number of leases */
-#define MAX_LEASES 32
+/* Maximum number of leases, also the largest address pool */
+#ifndef CONFIG_DHCPD_MAX_LEASES
+#define CONFIG_DHCPD_MAX_LEASES	256
+#endif
+#define MAX_LEASES CONFIG_DHCPD_MAX_LEASES
+
+/* Buckets of the MAC address hash, a power of two */
+#define DHCPD_HASH_SIZE		128
+
+/* Defaults for the dhcpd_pool_size and dhcpd_lease_time variables */
+#define DHCPD_DEF_POOL_SIZE	100
+#define DHCPD_DEF_LEASE_TIME	3600	/* seconds */
+/* Leases are timed in ticks, keep secs * CONFIG_SYS_HZ within a ulong */
+#define DHCPD_MAX_LEASE_TIME	(7 * 24 * 3600)
+
+/* How long an offered address is held without a REQUEST, in seconds */
+#define DHCPD_OFFER_TIME	30
 
 /* DHCP Error Codes */
 #define SUCCESS				0
@@ -99,6 +114,7 @@ struct dhcpd_lease {
 	struct in_addr ip_addr;
 	unsigned long lease_start;
 	unsigned long lease_time;
+	struct dhcpd_lease *next;	/* MAC hash chain or free list */
 };
 
 /* Server configuration */
@@ -108,6 +124,7 @@ struct dhcpd_svr_cfg {
 	struct in_addr end_ip;
 	struct in_addr netmask;
 	struct in_addr gateway;
+	unsigned long lease_time;	/* seconds */
 };
 
 /* Exported functions */
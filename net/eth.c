@@ -16,6 +16,9 @@
 #include <asm/errno.h>
 #include <dm/device-internal.h>
 #include <dm/uclass-internal.h>
+#ifdef CONFIG_IPQ_LAZY_INIT
+#include <asm/arch-qca-common/qca_common.h>
+#endif
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -101,8 +104,12 @@ static void eth_common_init(void)
 	 * If not, call a CPU-specific one
 	 */
 	if (board_eth_init != __def_eth_init) {
+		bootstage_mark_name(BOOTSTAGE_ID_BOARD_ETH_INIT,
+				    "board_eth_init");
 		if (board_eth_init(gd->bd) < 0)
 			printf("Board Net Initialization Failed\n");
+		bootstage_mark_name(BOOTSTAGE_ID_BOARD_ETH_INIT_DONE,
+				    "board_eth_init_done");
 	} else if (cpu_eth_init != __def_eth_init) {
 		if (cpu_eth_init(gd->bd) < 0)
 			printf("CPU Net Initialization Failed\n");
@@ -970,6 +977,10 @@ int eth_init(void)
 {
 	struct eth_device *old_current;
 
+#ifdef CONFIG_IPQ_LAZY_INIT
+	/* Covers the callers that bypass net_loop(), e.g. dhcpd and httpd */
+	ipq_lazy_init(IPQ_LAZY_NET);
+#endif
 	if (!eth_current) {
 		puts("No ethernet found.\n");
 		return -ENODEV;
@@ -94,6 +94,9 @@
 #endif
 #include <watchdog.h>
 #include <linux/compiler.h>
+#ifdef CONFIG_IPQ_LAZY_INIT
+#include <asm/arch-qca-common/qca_common.h>
+#endif
 #include "arp.h"
 #include "bootp.h"
 #include "cdp.h"
@@ -418,6 +421,9 @@ int net_loop(enum proto_t protocol)
 	net_try_count = 1;
 	debug_cond(DEBUG_INT_STATE, "--- net_loop Entry\n");
 
+#ifdef CONFIG_IPQ_LAZY_INIT
+	ipq_lazy_init(IPQ_LAZY_NET);
+#endif
 	bootstage_mark_name(BOOTSTAGE_ID_ETH_START, "eth_start");
 	net_init();
 	if (eth_is_on_demand_init() || protocol != NETCONS) {
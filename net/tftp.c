@@ -103,6 +103,8 @@ static unsigned short tftp_led_counter = 0;
 static int	tftp_put_active;
 /* 1 if we have sent the last block */
 static int	tftp_put_final_block_sent;
+/* Optional generator for the data being sent, see include/net.h */
+int (*tftp_put_source)(ulong offset, uchar *dst, unsigned len);
 #else
 #define tftp_put_active	0
 #endif
@@ -262,6 +264,12 @@ static int load_block(unsigned block, uchar *dst, unsigned len)
 	ulong tosend = len;
 
 	tosend = min(net_boot_file_size - offset, tosend);
+	if (tftp_put_source) {
+		int ret = tftp_put_source(offset, dst, tosend);
+
+		/* A short block ends the transfer, so does an error */
+		return ret < 0 ? 0 : ret;
+	}
 	(void)memcpy(dst, (void *)(save_addr + offset), tosend);
 	debug("%s: block=%d, offset=%ld, len=%d, tosend=%ld\n", __func__,
 	      block, offset, len, tosend);
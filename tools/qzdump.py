@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+######################################################################
+# Copyright (c) 2020 The Linux Foundation. All rights reserved.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 and
+# only version 2 as published by the Free Software Foundation.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#####################################################################
+
+"""
+Unpack crash dump segments stored in the .qz format (dump_compressed=2)
+back to raw memory images. See doc/README.qca-crashdump-qz.
+
+    qzdump.py EBICS0.BIN.qz                 -> EBICS0.BIN
+    qzdump.py EBICS0.BIN.qz.000             -> EBICS0.BIN (joins .001, ...)
+    qzdump.py -o ddr.bin EBICS0.BIN.qz
+    qzdump.py -m MANIFEST.TXT -d dumpdir    -> every file of the manifest
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+ZDUMP_MAGIC = 0x31445A51
+ZDUMP_VERSION = 1
+
+CHUNK_ZERO = 0
+CHUNK_RAW = 1
+CHUNK_DEFLATE = 2
+
+HDR = struct.Struct("<6I")	# magic version chunk_size nr_chunks addr size
+INDEX_ENT = struct.Struct("<3I")	# offset len type
+TRAILER = struct.Struct("<2I")	# index_offset magic
+
+
+class QzError(Exception):
+	pass
+
+
+def read_input(path):
+	"""Read a .qz file, or all the numbered parts of one written to USB."""
+	base, ext = os.path.splitext(path)
+	if len(ext) == 4 and ext[1:].isdigit():
+		data = bytearray()
+		part = 0
+		while os.path.exists("%s.%03d" % (base, part)):
+			with open("%s.%03d" % (base, part), "rb") as f:
+				data += f.read()
+			part += 1
+		if not part:
+			raise QzError("%s: no parts found" % path)
+		return bytes(data)
+
+	with open(path, "rb") as f:
+		return f.read()
+
+
+def unpack(data, out, stored=None):
+	"""Write the memory image held in data to the file object out."""
+	if stored is not None:
+		data = data[:stored]
+	if len(data) < HDR.size + TRAILER.size:
+		raise QzError("file too short")
+
+	magic, version, chunk_size, nr_chunks, addr, size = \
+		HDR.unpack_from(data, 0)
+	if magic != ZDUMP_MAGIC:
+		raise QzError("bad header magic 0x%08x" % magic)
+	if version != ZDUMP_VERSION:
+		raise QzError("unsupported version %d" % version)
+	if nr_chunks != (size + chunk_size - 1) // chunk_size:
+		raise QzError("chunk count does not match the size")
+
+	index_offset, tmagic = TRAILER.unpack_from(data, len(data) - TRAILER.size)
+	if tmagic != ZDUMP_MAGIC:
+		raise QzError("bad trailer, truncated or trailing data "
+			      "(use the stored size from MANIFEST.TXT)")
+	if index_offset + nr_chunks * INDEX_ENT.size + TRAILER.size != len(data):
+		raise QzError("index does not fit the file")
+
+	for i in range(nr_chunks):
+		offset, clen, ctype = INDEX_ENT.unpack_from(data,
+					index_offset + i * INDEX_ENT.size)
+		want = min(size - i * chunk_size, chunk_size)
+		if offset + clen > index_offset:
+			raise QzError("chunk %d out of bounds" % i)
+		blob = data[offset:offset + clen]
+
+		if ctype == CHUNK_ZERO:
+			chunk = bytes(want)
+		elif ctype == CHUNK_RAW:
+			chunk = blob
+		elif ctype == CHUNK_DEFLATE:
+			chunk = zlib.decompressobj(-zlib.MAX_WBITS).decompress(blob)
+		else:
+			raise QzError("chunk %d has unknown type %d" % (i, ctype))
+
+		if len(chunk) != want:
+			raise QzError("chunk %d unpacks to %d bytes, expected %d" %
+				      (i, len(chunk), want))
+		out.write(chunk)
+
+	return addr, size
+
+
+def out_name(path):
+	base = path
+	ext = os.path.splitext(base)[1]
+	if len(ext) == 4 and ext[1:].isdigit():
+		base = base[:-4]
+	if base.endswith(".qz"):
+		return base[:-3]
+	return base + ".bin"
+
+
+def unpack_file(path, output=None, stored=None):
+	output = output or out_name(path)
+	data = read_input(path)
+	with open(output, "wb") as out:
+		addr, size = unpack(data, out, stored)
+	print("%s: 0x%08x bytes at 0x%08x -> %s" % (path, size, addr, output))
+
+
+def main():
+	parser = argparse.ArgumentParser(
+		description="Unpack .qz crash dump segments.")
+	parser.add_argument("files", nargs="*",
+			    help=".qz files or the first .qz.NNN part")
+	parser.add_argument("-o", "--output",
+			    help="output file, only with a single input")
+	parser.add_argument("-m", "--manifest",
+			    help="unpack every file listed in MANIFEST.TXT")
+	parser.add_argument("-d", "--dir", default=".",
+			    help="directory holding the manifest's files")
+	args = parser.parse_args()
+
+	if args.output and len(args.files) != 1:
+		parser.error("-o needs exactly one input file")
+	if not args.files and not args.manifest:
+		parser.error("nothing to unpack")
+
+	try:
+		for path in args.files:
+			unpack_file(path, args.output)
+
+		if args.manifest:
+			with open(args.manifest) as f:
+				for line in f:
+					fields = line.split()
+					if len(fields) != 4:
+						continue
+					name, stored = fields[0], int(fields[3], 16)
+					path = os.path.join(args.dir, name)
+					if not os.path.exists(path):
+						path += ".000"
+					unpack_file(path, stored=stored)
+	except (QzError, IOError, zlib.error) as e:
+		sys.stderr.write("qzdump: %s\n" % e)
+		return 1
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())